@@ -0,0 +1,327 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "harness.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/normalization.h"
+#include "operators/reduce.h"
+#include "operators/softmax.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+
+namespace infini::bench
+{
+    struct KernelCase
+    {
+        string shape;
+        Graph graph;
+        Operator op;
+    };
+
+    // Build one graph per shape of the sweep holding a single op of opType.
+    using CaseBuilder = std::function<vector<KernelCase>(DataType)>;
+
+    static Graph newGraph()
+    {
+        return make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    }
+
+    static Operator addElementWise(const Graph &g, OpType type, Tensor a,
+                                   Tensor b)
+    {
+        if (type == OpType::Add)
+            return g->addOp<AddObj>(a, b, nullptr);
+        if (type == OpType::Sub)
+            return g->addOp<SubObj>(a, b, nullptr);
+        if (type == OpType::Mul)
+            return g->addOp<MulObj>(a, b, nullptr);
+        return g->addOp<DivObj>(a, b, nullptr);
+    }
+
+    static vector<KernelCase> elementWise(OpType type, DataType dtype)
+    {
+        vector<KernelCase> cases;
+        for (int n : {1 << 10, 1 << 16, 1 << 20})
+        {
+            auto g = newGraph();
+            auto op = addElementWise(g, type, g->addTensor({n}, dtype),
+                                     g->addTensor({n}, dtype));
+            cases.push_back({std::to_string(n), g, op});
+        }
+        // broadcast a row vector over a matrix
+        auto g = newGraph();
+        auto op = addElementWise(g, type, g->addTensor({1024, 1024}, dtype),
+                                 g->addTensor({1, 1024}, dtype));
+        cases.push_back({"1024x1024,1x1024", g, op});
+        return cases;
+    }
+
+    static vector<KernelCase> unary(OpType type, DataType dtype)
+    {
+        vector<KernelCase> cases;
+        for (int n : {1 << 10, 1 << 16, 1 << 20})
+        {
+            auto g = newGraph();
+            auto x = g->addTensor({n}, dtype);
+            Operator op;
+            switch (type.underlying())
+            {
+            case OpType::Relu:
+                op = g->addOp<ReluObj>(x, nullptr);
+                break;
+            case OpType::Clip:
+                op = g->addOp<ClipObj>(x, nullptr, 2.f, 5.f);
+                break;
+            case OpType::Erf:
+                op = g->addOp<ErfObj>(x, nullptr);
+                break;
+            case OpType::Exp:
+                op = g->addOp<ExpObj>(x, nullptr);
+                break;
+            case OpType::Gelu:
+                op = g->addOp<GeluObj>(x, nullptr);
+                break;
+            case OpType::Log:
+                op = g->addOp<LogObj>(x, nullptr);
+                break;
+            case OpType::Sigmoid:
+                op = g->addOp<SigmoidObj>(x, nullptr);
+                break;
+            case OpType::Silu:
+                op = g->addOp<SiluObj>(x, nullptr);
+                break;
+            case OpType::Tanh:
+                op = g->addOp<TanhObj>(x, nullptr);
+                break;
+            default:
+                IT_TODO_HALT();
+            }
+            cases.push_back({std::to_string(n), g, op});
+        }
+        return cases;
+    }
+
+    static vector<KernelCase> softmax(OpType type, DataType dtype)
+    {
+        vector<KernelCase> cases;
+        auto add = [&](const Shape &shape, int axis, const string &name) {
+            auto g = newGraph();
+            auto x = g->addTensor(shape, dtype);
+            Operator op;
+            if (type == OpType::Softmax)
+                op = g->addOp<SoftmaxObj>(x, nullptr, axis);
+            else
+                op = g->addOp<LogSoftmaxObj>(x, nullptr, axis);
+            cases.push_back({name, g, op});
+        };
+        add({1024, 1024}, -1, "1024x1024,axis=1");
+        // attention scores of 8 heads
+        add({8, 128, 128}, -1, "8x128x128,axis=2");
+        add({1024, 1024}, 0, "1024x1024,axis=0");
+        return cases;
+    }
+
+    static vector<KernelCase> normalization(OpType type, DataType dtype)
+    {
+        vector<KernelCase> cases;
+        // 1M elements in rows of the hidden width of small and large
+        // transformers
+        for (int width : {256, 4096})
+        {
+            int rows = (1 << 20) / width;
+            auto g = newGraph();
+            auto x = g->addTensor({rows, width}, dtype);
+            auto scale = g->addTensor({width}, dtype);
+            Operator op;
+            if (type == OpType::LayerNorm)
+                op = g->addOp<LayerNormObj>(
+                    x, scale, g->addTensor({width}, dtype), nullptr);
+            else
+                op = g->addOp<RMSNormObj>(x, scale, nullptr);
+            cases.push_back(
+                {std::to_string(rows) + "x" + std::to_string(width), g, op});
+        }
+        return cases;
+    }
+
+    static Operator addReduce(const Graph &g, OpType type, Tensor x,
+                              const vector<int> &axes)
+    {
+        if (type == OpType::ReduceSum)
+            return g->addOp<ReduceSumObj>(x, nullptr, axes);
+        if (type == OpType::ReduceMean)
+            return g->addOp<ReduceMeanObj>(x, nullptr, axes);
+        if (type == OpType::ReduceMax)
+            return g->addOp<ReduceMaxObj>(x, nullptr, axes);
+        if (type == OpType::ReduceMin)
+            return g->addOp<ReduceMinObj>(x, nullptr, axes);
+        return g->addOp<ReduceProdObj>(x, nullptr, axes);
+    }
+
+    static vector<KernelCase> reduce(OpType type, DataType dtype)
+    {
+        vector<KernelCase> cases;
+        // one case per strategy: contiguous rows, strided columns and the
+        // whole tensor
+        auto add = [&](const vector<int> &axes, const string &name) {
+            auto g = newGraph();
+            auto op = addReduce(g, type, g->addTensor({1024, 1024}, dtype),
+                                axes);
+            cases.push_back({name, g, op});
+        };
+        add({1}, "1024x1024,axes=1");
+        add({0}, "1024x1024,axes=0");
+        add({}, "1024x1024,all");
+        return cases;
+    }
+
+    static vector<KernelCase> matmul(DataType dtype)
+    {
+        vector<KernelCase> cases;
+        for (int n : {16, 64, 256, 512})
+            for (bool transB : {false, true})
+            {
+                auto g = newGraph();
+                auto a = g->addTensor({n, n}, dtype),
+                     b = g->addTensor({n, n}, dtype);
+                auto op = g->addOp<MatmulObj>(a, b, nullptr, false, transB);
+                cases.push_back({std::to_string(n) + "^3" +
+                                     (transB ? ",transB" : ""),
+                                 g, op});
+            }
+        // a batched product with a small inner dim
+        auto g = newGraph();
+        auto a = g->addTensor({8, 128, 32}, dtype),
+             b = g->addTensor({8, 32, 128}, dtype);
+        auto op = g->addOp<MatmulObj>(a, b, nullptr);
+        cases.push_back({"8x128x32x128", g, op});
+        return cases;
+    }
+
+    static vector<KernelCase> transpose(DataType dtype)
+    {
+        vector<KernelCase> cases;
+        auto add = [&](Shape shape, vector<int> perm, string name) {
+            auto g = newGraph();
+            auto op = g->addOp<TransposeObj>(g->addTensor(shape, dtype),
+                                             nullptr, perm);
+            cases.push_back({name, g, op});
+        };
+        add({256, 256}, {1, 0}, "256x256,perm=1,0");
+        add({1024, 1024}, {1, 0}, "1024x1024,perm=1,0");
+        add({32, 64, 512}, {0, 2, 1}, "32x64x512,perm=0,2,1");
+        add({16, 128, 8, 64}, {0, 2, 1, 3}, "16x128x8x64,perm=0,2,1,3");
+        return cases;
+    }
+
+    static vector<KernelCase> concat(DataType dtype)
+    {
+        vector<KernelCase> cases;
+        auto add = [&](Shape shape, int nInputs, int dim, string name) {
+            auto g = newGraph();
+            TensorVec inputs;
+            for (int i = 0; i < nInputs; ++i)
+                inputs.emplace_back(g->addTensor(shape, dtype));
+            auto op = g->addOp<ConcatObj>(inputs, nullptr, dim);
+            cases.push_back({name, g, op});
+        };
+        add({1024, 256}, 2, 0, "2x(1024x256),dim=0");
+        add({1024, 256}, 2, 1, "2x(1024x256),dim=1");
+        add({64, 64, 64}, 4, 2, "4x(64x64x64),dim=2");
+        return cases;
+    }
+
+    static const std::map<OpType::underlying_t, CaseBuilder> &getBuilders()
+    {
+        using namespace std::placeholders;
+        static const std::map<OpType::underlying_t, CaseBuilder> builders{
+            {OpType::Add, std::bind(elementWise, OpType::Add, _1)},
+            {OpType::Sub, std::bind(elementWise, OpType::Sub, _1)},
+            {OpType::Mul, std::bind(elementWise, OpType::Mul, _1)},
+            {OpType::Div, std::bind(elementWise, OpType::Div, _1)},
+            {OpType::Relu, std::bind(unary, OpType::Relu, _1)},
+            {OpType::Clip, std::bind(unary, OpType::Clip, _1)},
+            {OpType::Erf, std::bind(unary, OpType::Erf, _1)},
+            {OpType::Exp, std::bind(unary, OpType::Exp, _1)},
+            {OpType::Gelu, std::bind(unary, OpType::Gelu, _1)},
+            {OpType::Log, std::bind(unary, OpType::Log, _1)},
+            {OpType::Sigmoid, std::bind(unary, OpType::Sigmoid, _1)},
+            {OpType::Silu, std::bind(unary, OpType::Silu, _1)},
+            {OpType::Tanh, std::bind(unary, OpType::Tanh, _1)},
+            {OpType::Softmax, std::bind(softmax, OpType::Softmax, _1)},
+            {OpType::LogSoftmax, std::bind(softmax, OpType::LogSoftmax, _1)},
+            {OpType::LayerNorm,
+             std::bind(normalization, OpType::LayerNorm, _1)},
+            {OpType::RMSNorm, std::bind(normalization, OpType::RMSNorm, _1)},
+            {OpType::ReduceSum, std::bind(reduce, OpType::ReduceSum, _1)},
+            {OpType::ReduceMean, std::bind(reduce, OpType::ReduceMean, _1)},
+            {OpType::ReduceMax, std::bind(reduce, OpType::ReduceMax, _1)},
+            {OpType::ReduceMin, std::bind(reduce, OpType::ReduceMin, _1)},
+            {OpType::ReduceProd, std::bind(reduce, OpType::ReduceProd, _1)},
+            {OpType::MatMul, matmul},
+            {OpType::Transpose, transpose},
+            {OpType::Concat, concat},
+        };
+        return builders;
+    }
+
+    static int benchKernels(BenchRunner &runner)
+    {
+        auto runtime = NativeCpuRuntimeObj::getInstance();
+        auto &builders = getBuilders();
+        int missing = 0;
+        for (auto &[attrs, record] :
+             KernelRegistry::getInstance().getAllKernels())
+        {
+            auto [device, opType, isa] = attrs;
+            auto &[kernel, name, id] = *record;
+            if (device != Device::CPU || !runner.isEnabled(name))
+                continue;
+            if (isa > runtime->getIsaLevel())
+            {
+                std::cout << "skip " << name << ": needs "
+                          << isaLevelToString(isa) << "\n";
+                continue;
+            }
+            auto it = builders.find(opType);
+            if (it == builders.end())
+            {
+                std::cout << "no benchmark cases for " << name << "\n";
+                ++missing;
+                continue;
+            }
+            for (auto dtype : {DataType::Float32, DataType::Int32})
+                for (auto &c : it->second(dtype))
+                {
+                    if (!kernel->isApplicable(c.op))
+                        continue;
+                    c.graph->dataMalloc();
+                    for (auto &input : c.graph->getInputs())
+                        fillTensor(input);
+                    runner.run(name,
+                               {{"op", OpType(opType).toString()},
+                                {"isa", isaLevelToString(isa)},
+                                {"dtype", dtype.toString()},
+                                {"shape", c.shape}},
+                               [&, kernel = kernel]() {
+                                   kernel->compute(c.op, runtime.get());
+                               },
+                               c.op->getMinBytes(), c.op->getFlops());
+                }
+        }
+        return missing;
+    }
+
+} // namespace infini::bench
+
+int main(int argc, char **argv)
+{
+    using namespace infini::bench;
+    BenchRunner runner("kernels", BenchOptions::parse(argc, argv));
+    int missing = benchKernels(runner);
+    int regressions = runner.report();
+    // every registered kernel must have benchmark cases
+    return missing || regressions ? 1 : 0;
+}
@@ -0,0 +1,345 @@
+#include "core/graph.h"
+#include "core/profiler.h"
+#include "core/runtime.h"
+#include "harness.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/normalization.h"
+#include "operators/softmax.h"
+#include "operators/unary.h"
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+namespace infini::bench
+{
+    /**
+     * @brief A reference model built with addOp. Weights are bound to buffers
+     * of their own before compile, so that execution contexts share them;
+     * inputs live in the arena.
+     */
+    struct Model
+    {
+        Graph graph;
+        TensorVec inputs, outputs;
+    };
+
+    class ModelBuilder
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+
+    public:
+        Model model{make_ref<GraphObj>(runtime)};
+
+        Tensor input(Shape shape)
+        {
+            auto tensor = model.graph->addTensor(shape);
+            model.inputs.emplace_back(tensor);
+            return tensor;
+        }
+        // a weight of small values, scaled by its fan-in to keep activations
+        // in range
+        Tensor weight(Shape shape)
+        {
+            auto tensor = model.graph->addTensor(shape);
+            auto buffer = make_ref<vector<char>>(tensor->getBytes());
+            tensor->setDataBlob(
+                make_ref<BlobObj>(runtime, buffer->data(), buffer));
+            fillTensor(tensor, 1. / (7 * shape[0]));
+            return tensor;
+        }
+        // x * w + b
+        Tensor dense(Tensor x, int nIn, int nOut)
+        {
+            auto y = model.graph
+                         ->addOp<MatmulObj>(x, weight({nIn, nOut}), nullptr)
+                         ->getOutput();
+            return model.graph->addOp<AddObj>(y, weight({1, nOut}), nullptr)
+                ->getOutput();
+        }
+        Tensor relu(Tensor x)
+        {
+            return model.graph->addOp<ReluObj>(x, nullptr)->getOutput();
+        }
+        // LayerNorm over the last dim, with a scale of order 1 and a bias
+        Tensor layerNorm(Tensor x, int width)
+        {
+            auto scale = weight({width});
+            fillTensor(scale, 1. / 7);
+            return model.graph
+                ->addOp<LayerNormObj>(x, scale, weight({width}), nullptr)
+                ->getOutput();
+        }
+        Tensor mlp(Tensor x, vector<int> widths)
+        {
+            for (size_t i = 0; i + 1 < widths.size(); ++i)
+            {
+                x = dense(x, widths[i], widths[i + 1]);
+                if (i + 2 < widths.size())
+                    x = relu(x);
+            }
+            return x;
+        }
+        Model finish(Tensor output)
+        {
+            model.outputs.emplace_back(output);
+            return model;
+        }
+    };
+
+    // A 784-1024-1024-10 classifier.
+    static Model buildMlp(int batch)
+    {
+        ModelBuilder b;
+        auto x = b.input({batch, 784});
+        return b.finish(b.mlp(x, {784, 1024, 1024, 10}));
+    }
+
+    /**
+     * @brief A post-norm encoder block of width 256, 4 heads and a 1024
+     * wide feed-forward layer over sequences of 64: softmax attention, and
+     * LayerNorm after each residual sum.
+     */
+    static Model buildTransformer(int batch)
+    {
+        const int seq = 64, width = 256, heads = 4, headWidth = width / heads,
+                  ffn = 1024;
+        ModelBuilder b;
+        auto &g = b.model.graph;
+        auto x = b.input({batch, seq, width});
+        auto scale = b.weight(Shape{1});
+        *scale->getRawDataPtr<float *>() = 1. / std::sqrt(headWidth);
+        TensorVec contexts;
+        for (int h = 0; h < heads; ++h)
+        {
+            auto project = [&]() {
+                return g->addOp<MatmulObj>(x, b.weight({width, headWidth}),
+                                           nullptr)
+                    ->getOutput();
+            };
+            auto q = project(), k = project(), v = project();
+            auto scores =
+                g->addOp<MatmulObj>(q, k, nullptr, false, true)->getOutput();
+            scores = g->addOp<MulObj>(scores, scale, nullptr)->getOutput();
+            auto attention =
+                g->addOp<SoftmaxObj>(scores, nullptr, -1)->getOutput();
+            contexts.emplace_back(
+                g->addOp<MatmulObj>(attention, v, nullptr)->getOutput());
+        }
+        auto context = g->addOp<ConcatObj>(contexts, nullptr, 2)->getOutput();
+        auto attended = g->addOp<AddObj>(x, b.dense(context, width, width),
+                                         nullptr)
+                            ->getOutput();
+        attended = b.layerNorm(attended, width);
+        auto y = b.mlp(attended, {width, ffn, width});
+        return b.finish(b.layerNorm(
+            g->addOp<AddObj>(attended, y, nullptr)->getOutput(), width));
+    }
+
+    /**
+     * @brief A recommendation tower: a bottom MLP over 13 dense features,
+     * concatenated with 26 embeddings of width 16 looked up by the caller,
+     * and a top MLP to a clipped score.
+     */
+    static Model buildRecommendation(int batch)
+    {
+        ModelBuilder b;
+        auto &g = b.model.graph;
+        auto dense = b.input({batch, 13});
+        auto embeddings = b.input({batch, 26 * 16});
+        auto bottom = b.relu(b.mlp(dense, {13, 512, 256, 64}));
+        auto features =
+            g->addOp<ConcatObj>(TensorVec{bottom, embeddings}, nullptr, 1)
+                ->getOutput();
+        auto score = b.mlp(features, {64 + 26 * 16, 512, 256, 1});
+        return b.finish(
+            g->addOp<ClipObj>(score, nullptr, 0.f, 1.f)->getOutput());
+    }
+
+    static double getFlops(const Graph &graph)
+    {
+        double flops = 0;
+        for (auto &op : graph->getOperators())
+            flops += op->getFlops();
+        return flops;
+    }
+
+    static vector<int> parseList(const string &str)
+    {
+        vector<int> ret;
+        std::istringstream is(str);
+        for (string item; std::getline(is, item, ',');)
+            ret.emplace_back(std::stoi(item));
+        return ret;
+    }
+
+    struct LoadOptions
+    {
+        vector<int> threads;
+        // batch sizes of each model, the defaults if empty
+        vector<int> batches;
+        // requests in flight; more than 1 runs them with runAsync
+        int concurrency = 1;
+        // print the per-op profile of each case
+        bool profile = false;
+    };
+
+    /**
+     * @brief A closed loop load generator: concurrency clients each send the
+     * next request when the previous one completed, until reps requests are
+     * done. Returns the latency of each request in ms.
+     */
+    static vector<double> generateLoad(const Model &model, int reps,
+                                       int concurrency)
+    {
+        auto runtime = model.graph->getRuntime();
+        using Clock = std::chrono::steady_clock;
+        vector<double> latencies(reps);
+        if (concurrency == 1)
+        {
+            for (auto &latency : latencies)
+            {
+                auto begin = Clock::now();
+                runtime->run(model.graph);
+                latency = std::chrono::duration<double, std::milli>(
+                              Clock::now() - begin)
+                              .count();
+            }
+            return latencies;
+        }
+        vector<std::pair<Tensor, vector<char>>> inputs;
+        for (auto &input : model.inputs)
+        {
+            auto ptr = input->getRawDataPtr<char *>();
+            inputs.emplace_back(input,
+                                vector<char>(ptr, ptr + input->getBytes()));
+        }
+        std::atomic<int> next = 0;
+        vector<std::thread> clients;
+        for (int c = 0; c < concurrency; ++c)
+            clients.emplace_back([&]() {
+                for (int i; (i = next++) < reps;)
+                {
+                    auto begin = Clock::now();
+                    runtime->runAsync(model.graph, inputs, model.outputs).get();
+                    latencies[i] = std::chrono::duration<double, std::milli>(
+                                       Clock::now() - begin)
+                                       .count();
+                }
+            });
+        for (auto &client : clients)
+            client.join();
+        return latencies;
+    }
+
+    static void benchModel(BenchRunner &runner, const LoadOptions &load,
+                           const string &name,
+                           const std::function<Model(int)> &build,
+                           vector<int> batches)
+    {
+        if (!runner.isEnabled(name))
+            return;
+        if (!load.batches.empty())
+            batches = load.batches;
+        auto runtime = NativeCpuRuntimeObj::getInstance();
+        auto &options = runner.getOptions();
+        using Clock = std::chrono::steady_clock;
+        for (int batch : batches)
+            for (int threads : load.threads)
+            {
+                runtime->setParallelism(threads);
+                auto begin = Clock::now();
+                auto model = build(batch);
+                auto built = Clock::now();
+                model.graph->compile();
+                auto compiled = Clock::now();
+                for (auto &input : model.inputs)
+                    fillTensor(input, 0.1);
+
+                generateLoad(model, options.warmup * load.concurrency,
+                             load.concurrency);
+                Ref<Profiler> profiler;
+                if (load.profile)
+                {
+                    profiler = make_ref<Profiler>();
+                    runtime->setProfiler(profiler);
+                }
+                auto start = Clock::now();
+                BenchResult result{name,
+                                   {{"batch", std::to_string(batch)},
+                                    {"threads", std::to_string(threads)},
+                                    {"concurrency",
+                                     std::to_string(load.concurrency)}}};
+                result.samplesMs =
+                    generateLoad(model, options.reps, load.concurrency);
+                double seconds = std::chrono::duration<double>(
+                                     Clock::now() - start)
+                                     .count();
+                runtime->setProfiler(nullptr);
+                if (profiler)
+                    std::cout << name << " batch=" << batch
+                              << " threads=" << threads << "\n"
+                              << profiler->report()
+                              << profiler->roofline(
+                                     probeMachinePeak(runtime.get()))
+                              << "\n";
+                result.flops = getFlops(model.graph);
+                auto ms = [](auto from, auto to) {
+                    return std::chrono::duration<double, std::milli>(to - from)
+                        .count();
+                };
+                result.metrics = {
+                    {"samples_per_s", options.reps * batch / seconds},
+                    {"arena_bytes", double(model.graph->getArenaBytes())},
+                    {"build_ms", ms(begin, built)},
+                    {"prepare_ms", ms(built, compiled)},
+                };
+                runner.add(std::move(result));
+            }
+        runtime->setParallelism(RuntimeObj::getDefaultThreadCount());
+    }
+
+} // namespace infini::bench
+
+int main(int argc, char **argv)
+{
+    using namespace infini;
+    using namespace infini::bench;
+    vector<string> rest;
+    auto options = BenchOptions::parse(argc, argv, &rest);
+    LoadOptions load;
+    for (size_t i = 0; i < rest.size(); ++i)
+    {
+        if (rest[i] == "--profile")
+        {
+            load.profile = true;
+            continue;
+        }
+        IT_ASSERT(i + 1 < rest.size(), "Missing value of " + rest[i]);
+        if (rest[i] == "--threads")
+            load.threads = parseList(rest[++i]);
+        else if (rest[i] == "--batches")
+            load.batches = parseList(rest[++i]);
+        else if (rest[i] == "--concurrency")
+            load.concurrency = std::stoi(rest[++i]);
+        else
+            IT_TODO_HALT_MSG("Unknown argument " + rest[i]);
+    }
+    if (load.threads.empty())
+    {
+        // powers of two up to the default thread count, and the count itself
+        int maxThreads = RuntimeObj::getDefaultThreadCount();
+        for (int n = 1; n < maxThreads; n *= 2)
+            load.threads.emplace_back(n);
+        load.threads.emplace_back(maxThreads);
+    }
+    IT_ASSERT(load.concurrency > 0);
+
+    BenchRunner runner("models", options);
+    benchModel(runner, load, "mlp", buildMlp, {1, 16, 64});
+    benchModel(runner, load, "transformer_block", buildTransformer, {1, 4, 8});
+    benchModel(runner, load, "recommendation", buildRecommendation,
+               {1, 64, 256});
+    return runner.report() ? 1 : 0;
+}
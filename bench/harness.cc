@@ -0,0 +1,403 @@
+#include "harness.h"
+#include "core/isa.h"
+#include "core/runtime.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace infini::bench
+{
+    BenchOptions BenchOptions::parse(int argc, char **argv,
+                                     vector<string> *rest)
+    {
+        BenchOptions options;
+        for (int i = 1; i < argc; ++i)
+        {
+            string arg = argv[i];
+            auto value = [&]() {
+                IT_ASSERT(i + 1 < argc, "Missing value of " + arg);
+                return string(argv[++i]);
+            };
+            if (arg == "--warmup")
+                options.warmup = std::stoi(value());
+            else if (arg == "--reps")
+                options.reps = std::stoi(value());
+            else if (arg == "--filter")
+                options.filter = value();
+            else if (arg == "--json")
+                options.jsonPath = value();
+            else if (arg == "--baseline")
+                options.baselinePath = value();
+            else if (arg == "--threshold")
+                options.threshold = std::stod(value());
+            else if (rest)
+                rest->emplace_back(arg);
+            else
+                IT_TODO_HALT_MSG("Unknown argument " + arg);
+        }
+        IT_ASSERT(options.warmup >= 0 && options.reps > 0);
+        return options;
+    }
+
+    void BenchResult::summarize()
+    {
+        IT_ASSERT(!samplesMs.empty());
+        auto sorted = samplesMs;
+        std::sort(sorted.begin(), sorted.end());
+        size_t n = sorted.size();
+        medianMs = n % 2 ? sorted[n / 2]
+                         : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+        // nearest rank
+        auto percentile = [&](double p) {
+            return sorted[std::min(n - 1, size_t(std::ceil(p * n)) - 1)];
+        };
+        p95Ms = percentile(0.95);
+        p99Ms = percentile(0.99);
+        minMs = sorted.front();
+        meanMs = 0;
+        for (auto sample : sorted)
+            meanMs += sample;
+        meanMs /= n;
+        stddevMs = 0;
+        for (auto sample : sorted)
+            stddevMs += (sample - meanMs) * (sample - meanMs);
+        stddevMs = n > 1 ? std::sqrt(stddevMs / (n - 1)) : 0;
+    }
+
+    bool BenchRunner::isEnabled(const string &name) const
+    {
+        return name.find(options.filter) != string::npos;
+    }
+
+    BenchResult *BenchRunner::run(const string &name,
+                                  std::map<string, string> labels,
+                                  const std::function<void()> &fn,
+                                  double bytes, double flops)
+    {
+        if (!isEnabled(name))
+            return nullptr;
+        for (int i = 0; i < options.warmup; ++i)
+            fn();
+        BenchResult result{name, std::move(labels)};
+        for (int i = 0; i < options.reps; ++i)
+        {
+            auto begin = std::chrono::steady_clock::now();
+            fn();
+            auto end = std::chrono::steady_clock::now();
+            result.samplesMs.emplace_back(
+                std::chrono::duration<double, std::milli>(end - begin).count());
+        }
+        result.bytes = bytes;
+        result.flops = flops;
+        return &add(std::move(result));
+    }
+
+    BenchResult &BenchRunner::add(BenchResult result)
+    {
+        if (result.medianMs == 0 && !result.samplesMs.empty())
+            result.summarize();
+        results.emplace_back(std::move(result));
+        return results.back();
+    }
+
+    static string labelString(const std::map<string, string> &labels)
+    {
+        string ret;
+        for (auto &[key, value] : labels)
+            ret += (ret.empty() ? "" : " ") + key + "=" + value;
+        return ret;
+    }
+
+    int BenchRunner::report() const
+    {
+        std::cout << std::left << std::setw(28) << "benchmark" << std::setw(44)
+                  << "case" << std::right << std::setw(12) << "median ms"
+                  << std::setw(12) << "p95 ms" << std::setw(12) << "p99 ms"
+                  << std::setw(10) << "GB/s" << std::setw(10) << "GFLOP/s"
+                  << "\n";
+        for (auto &result : results)
+        {
+            std::cout << std::left << std::setw(28) << result.name
+                      << std::setw(44) << labelString(result.labels)
+                      << std::right << std::fixed << std::setprecision(4)
+                      << std::setw(12) << result.medianMs << std::setw(12)
+                      << result.p95Ms << std::setw(12) << result.p99Ms
+                      << std::setprecision(2) << std::setw(10)
+                      << (result.bytes ? result.getGBps() : 0) << std::setw(10)
+                      << (result.flops ? result.getGFlops() : 0);
+            for (auto &[key, value] : result.metrics)
+                std::cout << "  " << key << "=" << value;
+            std::cout << "\n";
+        }
+        std::cout.unsetf(std::ios::floatfield);
+        if (!options.jsonPath.empty())
+        {
+            std::ofstream file(options.jsonPath);
+            IT_ASSERT(file.good(), "Cannot write " + options.jsonPath);
+            file << toJson();
+            std::cout << "results written to " << options.jsonPath << "\n";
+        }
+        if (options.baselinePath.empty())
+            return 0;
+        std::ifstream file(options.baselinePath);
+        IT_ASSERT(file.good(), "Cannot read " + options.baselinePath);
+        std::ostringstream json;
+        json << file.rdbuf();
+        return compare(json.str());
+    }
+
+    static string quote(const string &str)
+    {
+        string ret = "\"";
+        for (char c : str)
+        {
+            if (c == '"' || c == '\\')
+                ret += '\\';
+            ret += c;
+        }
+        return ret + "\"";
+    }
+
+    static string number(double value)
+    {
+        if (!std::isfinite(value))
+            return "null";
+        std::ostringstream os;
+        os << std::setprecision(9) << value;
+        return os.str();
+    }
+
+    string BenchRunner::toJson() const
+    {
+        auto runtime = NativeCpuRuntimeObj::getInstance();
+        std::ostringstream os;
+        os << "{\n  \"suite\": " << quote(suite) << ",\n  \"host\": {\"isa\": "
+           << quote(isaLevelToString(runtime->getIsaLevel()))
+           << ", \"threads\": " << runtime->getThreadCount()
+           << "},\n  \"warmup\": " << options.warmup
+           << ",\n  \"reps\": " << options.reps << ",\n  \"results\": [";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            auto &result = results[i];
+            os << (i ? ",\n" : "\n") << "    {\"name\": " << quote(result.name)
+               << ", \"labels\": {";
+            size_t j = 0;
+            for (auto &[key, value] : result.labels)
+                os << (j++ ? ", " : "") << quote(key) << ": " << quote(value);
+            os << "},\n     \"median_ms\": " << number(result.medianMs)
+               << ", \"p95_ms\": " << number(result.p95Ms)
+               << ", \"p99_ms\": " << number(result.p99Ms)
+               << ", \"mean_ms\": " << number(result.meanMs)
+               << ", \"stddev_ms\": " << number(result.stddevMs)
+               << ", \"min_ms\": " << number(result.minMs)
+               << ", \"samples\": " << result.samplesMs.size();
+            if (result.bytes)
+                os << ", \"gbps\": " << number(result.getGBps());
+            if (result.flops)
+                os << ", \"gflops\": " << number(result.getGFlops());
+            os << ",\n     \"metrics\": {";
+            j = 0;
+            for (auto &[key, value] : result.metrics)
+                os << (j++ ? ", " : "") << quote(key) << ": " << number(value);
+            os << "}}";
+        }
+        os << "\n  ]\n}\n";
+        return os.str();
+    }
+
+    // A JSON value, enough to read back the results written by toJson.
+    struct JsonValue
+    {
+        enum class Kind
+        {
+            Null,
+            Number,
+            String,
+            Array,
+            Object
+        } kind = Kind::Null;
+        double number = 0;
+        string str;
+        vector<JsonValue> items;
+        std::map<string, JsonValue> members;
+
+        const JsonValue &operator[](const string &key) const
+        {
+            static const JsonValue null;
+            auto it = members.find(key);
+            return it == members.end() ? null : it->second;
+        }
+    };
+
+    class JsonParser
+    {
+        const string &text;
+        size_t pos = 0;
+
+        void skipSpace()
+        {
+            while (pos < text.size() && isspace(text[pos]))
+                ++pos;
+        }
+        void expect(char c)
+        {
+            skipSpace();
+            IT_ASSERT(pos < text.size() && text[pos] == c,
+                      string("Expected '") + c + "' in JSON at " +
+                          std::to_string(pos));
+            ++pos;
+        }
+        bool consume(char c)
+        {
+            skipSpace();
+            if (pos < text.size() && text[pos] == c)
+            {
+                ++pos;
+                return true;
+            }
+            return false;
+        }
+        string parseString()
+        {
+            expect('"');
+            string ret;
+            for (; pos < text.size() && text[pos] != '"'; ++pos)
+            {
+                if (text[pos] == '\\')
+                    ++pos;
+                ret += text[pos];
+            }
+            expect('"');
+            return ret;
+        }
+
+    public:
+        explicit JsonParser(const string &text) : text(text) {}
+
+        JsonValue parse()
+        {
+            JsonValue value;
+            skipSpace();
+            IT_ASSERT(pos < text.size(), "Unexpected end of JSON");
+            char c = text[pos];
+            if (c == '{')
+            {
+                value.kind = JsonValue::Kind::Object;
+                ++pos;
+                if (consume('}'))
+                    return value;
+                do
+                {
+                    auto key = parseString();
+                    expect(':');
+                    value.members[key] = parse();
+                } while (consume(','));
+                expect('}');
+            }
+            else if (c == '[')
+            {
+                value.kind = JsonValue::Kind::Array;
+                ++pos;
+                if (consume(']'))
+                    return value;
+                do
+                    value.items.emplace_back(parse());
+                while (consume(','));
+                expect(']');
+            }
+            else if (c == '"')
+            {
+                value.kind = JsonValue::Kind::String;
+                value.str = parseString();
+            }
+            else if (text.compare(pos, 4, "null") == 0)
+                pos += 4;
+            else
+            {
+                value.kind = JsonValue::Kind::Number;
+                size_t length;
+                value.number = std::stod(text.substr(pos, 32), &length);
+                pos += length;
+            }
+            return value;
+        }
+    };
+
+    // One-sided 99% quantile of Student's t distribution, by the
+    // Cornish-Fisher expansion around the normal quantile.
+    static double tQuantile99(double df)
+    {
+        double z = 2.3263;
+        return z + (z * z * z + z) / (4 * df) +
+               (5 * std::pow(z, 5) + 16 * z * z * z + 3 * z) / (96 * df * df);
+    }
+
+    int BenchRunner::compare(const string &baselineJson) const
+    {
+        auto baseline = JsonParser(baselineJson).parse();
+        std::map<string, const JsonValue *> cases;
+        for (auto &item : baseline["results"].items)
+        {
+            std::map<string, string> labels;
+            for (auto &[key, value] : item["labels"].members)
+                labels[key] = value.str;
+            cases[item["name"].str + " " + labelString(labels)] = &item;
+        }
+        int regressions = 0, compared = 0;
+        std::cout << "\ncomparison with " << options.baselinePath << "\n";
+        for (auto &result : results)
+        {
+            auto key = result.name + " " + labelString(result.labels);
+            auto it = cases.find(key);
+            if (it == cases.end() || (*it->second)["median_ms"].number <= 0)
+            {
+                std::cout << "  new       " << key << "\n";
+                continue;
+            }
+            ++compared;
+            auto &base = *it->second;
+            double n0 = base["samples"].number, n1 = result.samplesMs.size();
+            double mean0 = base["mean_ms"].number,
+                   sd0 = base["stddev_ms"].number;
+            double var0 = sd0 * sd0 / n0,
+                   var1 = result.stddevMs * result.stddevMs / n1;
+            double ratio = result.medianMs / base["median_ms"].number;
+            // Welch's t-test of the means
+            double diff = result.meanMs - mean0;
+            bool slower;
+            if (var0 + var1 == 0)
+                slower = diff > 0;
+            else
+            {
+                double df = (var0 + var1) * (var0 + var1) /
+                            (var0 * var0 / std::max(n0 - 1, 1.) +
+                             var1 * var1 / std::max(n1 - 1, 1.));
+                slower = diff / std::sqrt(var0 + var1) > tQuantile99(df);
+            }
+            bool regressed = slower && ratio > 1 + options.threshold;
+            regressions += regressed;
+            if (regressed || ratio < 1 - options.threshold)
+                std::cout << (regressed ? "  REGRESSED " : "  faster    ")
+                          << key << ": " << std::setprecision(4)
+                          << base["median_ms"].number << " -> "
+                          << result.medianMs << " ms (x" << ratio << ")\n";
+        }
+        std::cout << std::setprecision(6) << compared << " cases compared, "
+                  << regressions << " regressed\n";
+        return regressions;
+    }
+
+    void fillTensor(const Tensor &tensor, double scale)
+    {
+        dispatchDType<AllDTypes>(tensor->getDType(), [&](auto dt) {
+            using T = typename decltype(dt)::t;
+            auto ptr = tensor->getRawDataPtr<T *>();
+            for (size_t i = 0; i < tensor->size(); ++i)
+                ptr[i] = T((i % 7 + 1) * scale);
+        });
+    }
+
+} // namespace infini::bench
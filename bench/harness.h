@@ -0,0 +1,100 @@
+#pragma once
+#include "core/common.h"
+#include "core/tensor.h"
+#include <functional>
+#include <map>
+
+namespace infini::bench
+{
+    struct BenchOptions
+    {
+        int warmup = 3;
+        int reps = 20;
+        // only benchmarks whose name contains filter run
+        string filter;
+        // write the results as JSON here if not empty
+        string jsonPath;
+        // compare the results with the JSON results of an earlier run
+        string baselinePath;
+        // smallest relative slowdown of the median reported as a regression
+        double threshold = 0.05;
+
+        /**
+         * @brief Parse --warmup N, --reps N, --filter S, --json PATH,
+         * --baseline PATH and --threshold R. Unknown arguments are left to
+         * the caller in rest.
+         */
+        static BenchOptions parse(int argc, char **argv,
+                                  vector<string> *rest = nullptr);
+    };
+
+    struct BenchResult
+    {
+        string name;
+        // parameters of the case, e.g. shape and data type
+        std::map<string, string> labels;
+        vector<double> samplesMs;
+        double medianMs = 0, p95Ms = 0, p99Ms = 0, meanMs = 0, stddevMs = 0,
+               minMs = 0;
+        // bytes moved and floating point operations of one repetition, 0 if
+        // not meaningful
+        double bytes = 0, flops = 0;
+        // further figures, e.g. throughput or arena size
+        std::map<string, double> metrics;
+
+        double getGBps() const { return bytes / medianMs * 1e-6; }
+        double getGFlops() const { return flops / medianMs * 1e-6; }
+        // fill in the statistics from samplesMs
+        void summarize();
+    };
+
+    /**
+     * @brief Times benchmark cases and reports them as a table on stdout and
+     * as JSON.
+     */
+    class BenchRunner
+    {
+        string suite;
+        BenchOptions options;
+        vector<BenchResult> results;
+
+    public:
+        BenchRunner(string suite, BenchOptions options)
+            : suite(std::move(suite)), options(std::move(options)) {}
+
+        bool isEnabled(const string &name) const;
+        const BenchOptions &getOptions() const { return options; }
+
+        /**
+         * @brief Run fn warmup times, then time reps runs of it and record
+         * the result unless the name is filtered out.
+         */
+        BenchResult *run(const string &name, std::map<string, string> labels,
+                         const std::function<void()> &fn, double bytes = 0,
+                         double flops = 0);
+        // record a result measured by the caller
+        BenchResult &add(BenchResult result);
+
+        const vector<BenchResult> &getResults() const { return results; }
+        /**
+         * @brief Print the results, write them as JSON and compare them with
+         * the baseline if the options ask so.
+         * @return the number of regressions against the baseline.
+         */
+        int report() const;
+        string toJson() const;
+        /**
+         * @brief Compare the results with the cases of the same name and
+         * labels in the JSON results of an earlier run. A case regressed if
+         * its median is more than threshold slower and Welch's t-test on the
+         * repetitions finds its mean slower at the 1% level.
+         * @return the number of regressions.
+         */
+        int compare(const string &baselineJson) const;
+    };
+
+    // Fill a bound tensor with small non-zero values of its data type, times
+    // scale.
+    void fillTensor(const Tensor &tensor, double scale = 1);
+
+} // namespace infini::bench
@@ -11,6 +11,25 @@
 namespace infini {
   class Allocator
   {
+  public:
+    // a simulated allocation or free, or a block taken over in place
+    struct Event
+    {
+      enum Kind
+      {
+        Alloc,
+        Free,
+        Reuse
+      } kind;
+      // index of the op being planned, -1 before the first one
+      int step;
+      // guid of the tensor, -1 if not given
+      UidBaseType tensor;
+      size_t offset, size;
+      // bytes in use and end of the arena after the event
+      size_t used, top;
+    };
+
   private:
     Runtime runtime;
 
@@ -18,6 +37,10 @@ namespace infini {
 
     size_t peak;
 
+    // end of the simulated arena, blocks are only carved above it when no
+    // free block fits
+    size_t top;
+
     size_t alignment;
 
     // pointer to the memory actually allocated
@@ -29,6 +52,10 @@ namespace infini {
     // =================================== 作业 ===================================
     //<address, blocksize>
     std::map<size_t, size_t> free_blocks;
+
+    // every simulated event, in order
+    vector<Event> timeline;
+    int step = -1;
   
     
   public:
@@ -39,30 +66,64 @@ namespace infini {
     // function: simulate memory allocation
     // arguments：
     //     size: size of memory block to be allocated
+    //     tensor: guid of the tensor recorded in the timeline
     // return: head address offset of the allocated memory block
-    size_t alloc(size_t size);
+    size_t alloc(size_t size, UidBaseType tensor = -1);
 
     // function: simulate memory free
     // arguments:
     //     addr: head address offset of memory block to be free
     //     size: size of memory block to be freed
-    void free(size_t addr, size_t size);
+    //     tensor: guid of the tensor recorded in the timeline
+    void free(size_t addr, size_t size, UidBaseType tensor = -1);
+
+    // function: record that a tensor takes over an allocated block, e.g. the
+    //           output of an op computed in place
+    void reuse(size_t addr, size_t size, UidBaseType tensor);
+
+    // function: attribute the following events to the op at index step
+    void setStep(int step_) { step = step_; }
+
+    const vector<Event> &getTimeline() const { return timeline; }
+
+    // function: replay the timeline up to and including an event
+    // return: the Alloc or Reuse events of the blocks live after it, by
+    //         offset
+    vector<Event> getLiveBlocks(size_t index) const;
 
     // function: perform actual memory allocation
+    // arguments:
+    //     zero: whether the memory must be zeroed, callers which write every
+    //           byte before reading it may skip it
     // return: pointer to the head address of the allocated memory
-    void *getPtr();
+    void *getPtr(bool zero = true);
+
+    // return: the allocated memory, or nullptr before getPtr was called
+    void *getBasePtr() const { return ptr; }
 
+    // function: print the bytes in use and the peak, and, from the timeline,
+    //           the worst fragmentation and the largest tensors live at the
+    //           peak
     void info();
 
+    size_t getPeak() const { return peak; }
+
+    // function: set the arena size directly instead of simulating
+    //           allocations, used when applying a precompiled plan
+    void setPeak(size_t size);
+
   private:
     // function: memory alignment, rouned up
     // return: size of the aligned memory block
     size_t getAlignedSize(size_t size);
     
-    // function: merge adjacent free blocks
+    // function: merge adjacent free blocks, and give the block back to the
+    //           top of the arena if it ends there
     // arguments:
     //     addr: address of the newly freed block
-    //     size: size of the newly freed block
-    void mergeAdjacentBlocks(size_t addr, size_t size);
+    void mergeAdjacentBlocks(size_t addr);
+
+    void record(Event::Kind kind, UidBaseType tensor, size_t addr,
+                size_t size);
   };
 }
@@ -0,0 +1,85 @@
+#pragma once
+#include "core/graph.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <thread>
+
+namespace infini
+{
+    /**
+     * @brief The data of one sample, one byte buffer per input or output of
+     * the graph, without the batch dimension.
+     */
+    using SampleData = vector<vector<char>>;
+
+    /**
+     * @brief A graph built for one batch size. The batch dimension is the
+     * first dimension of every input and output.
+     */
+    struct BatchBucket
+    {
+        Graph graph;
+        TensorVec inputs, outputs;
+    };
+
+    struct BatchingOptions
+    {
+        // batch sizes with a pre-planned graph, a batch of n requests runs in
+        // the smallest bucket not below n
+        vector<int> buckets{1, 2, 4, 8};
+        // how long the oldest queued request may wait for others to join
+        std::chrono::microseconds timeout{1000};
+    };
+
+    /**
+     * @brief Serve single-sample requests by merging them along the batch
+     * dimension. Requests are queued until the largest bucket is full or the
+     * oldest one has waited for the timeout, then run as one batch on a
+     * worker thread and the outputs are scattered back through futures.
+     */
+    class DynamicBatcher
+    {
+    public:
+        /**
+         * @brief Build and compile a graph for every bucket. Weights have to
+         * be bound by build, e.g. shared between the buckets.
+         */
+        DynamicBatcher(std::function<BatchBucket(int batch)> build,
+                       BatchingOptions options = {});
+        DynamicBatcher(const DynamicBatcher &) = delete;
+        // runs the queued requests before returning
+        ~DynamicBatcher();
+
+        std::future<SampleData> submit(SampleData inputs);
+
+        // number of batches run, for monitoring
+        size_t getBatchCount() const { return batchCount; }
+
+    private:
+        struct Request
+        {
+            SampleData inputs;
+            std::promise<SampleData> result;
+            std::chrono::steady_clock::time_point arrival;
+        };
+
+        BatchingOptions options;
+        std::map<int, BatchBucket> buckets;
+        vector<size_t> inputBytes, outputBytes;
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<Request> queue;
+        bool stopping = false;
+        std::atomic<size_t> batchCount{0};
+        std::thread worker;
+
+        void serve();
+        void runBatch(vector<Request> &batch);
+    };
+
+} // namespace infini
@@ -1,5 +1,6 @@
 #pragma once
 #include "core/common.h"
+#include "core/execution.h"
 #include "core/ref.h"
 
 namespace infini {
@@ -11,15 +12,32 @@ class BlobObj
 {
   Runtime runtime;
   void *ptr;
+  // keeps memory not owned by an allocator alive, e.g. a mapped graph file
+  Ref<void> storage;
+  // set for blobs in the arena of an allocator, which an execution context
+  // of that allocator redirects
+  const Allocator *arena = nullptr;
+  size_t offset = 0;
 
 public:
   BlobObj(Runtime runtime, void *ptr) : runtime(runtime), ptr(ptr) {}
+  BlobObj(Runtime runtime, void *ptr, Ref<void> storage)
+      : runtime(runtime), ptr(ptr), storage(std::move(storage)) {}
+  BlobObj(Runtime runtime, void *ptr, const Allocator *arena, size_t offset)
+      : runtime(runtime), ptr(ptr), arena(arena), offset(offset) {}
   BlobObj(BlobObj &other) = delete;
   BlobObj &operator=(BlobObj const &) = delete;
   ~BlobObj() {};
 
   template <typename T>
-  T getPtr() const { return reinterpret_cast<T>(ptr); }
+  T getPtr() const {
+    if (arena) {
+      auto context = ExecutionContextObj::getCurrent();
+      if (context && context->getArena() == arena)
+        return reinterpret_cast<T>(context->getBase() + offset);
+    }
+    return reinterpret_cast<T>(ptr);
+  }
 };
 
 } // namespace infini
@@ -1,5 +1,7 @@
 #pragma once
 #include "core/common.h"
+#include <algorithm>
+#include <array>
 #include <cstdint>
 
 namespace infini {
@@ -60,6 +62,7 @@ class DataType {
     DataType() = default;
     constexpr DataType(int index) : index(index) {}
     bool operator==(const DataType &rhs) const { return index == rhs.index; }
+    bool operator!=(const DataType &rhs) const { return index != rhs.index; }
     bool operator<(const DataType &rhs) const { return index < rhs.index; }
 
     template <typename T> static int get() {
@@ -101,4 +104,60 @@ template <> struct DT<12> { using t = uint32_t; };
 template <> struct DT<13> { using t = uint64_t; };
 template <> struct DT<16> { using t = uint16_t; };
 
+/**
+ * @brief A compile-time list of DataType indices. Kernels declare the list
+ * they support and dispatchDType instantiates one entry per index.
+ */
+template <int... Ns> struct DTypeList {
+    static constexpr int maxIndex = std::max({0, Ns...});
+};
+
+// Every DataType that has a cpu storage type, String included. printData
+// and equalData dispatch on it.
+using AllDTypes = DTypeList<0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 16>;
+// DataTypes whose storage type is also the arithmetic type, i.e. excluding
+// Bool, Float16 and BFloat16 which are stored as raw integers.
+using NumericDTypes = DTypeList<1, 2, 3, 4, 5, 6, 7, 11, 12, 13>;
+// DataTypes with a floating point storage type.
+using FloatDTypes = DTypeList<1, 11>;
+// DataTypes that can be moved element by element without interpreting them.
+using CopyableDTypes = DTypeList<1, 2, 3, 4, 5, 6, 7, 9, 10, 11, 12, 13, 16>;
+
+/**
+ * @brief Tag passed to dispatched functors, `typename decltype(tag)::t` is the
+ * cpu type of the DataType.
+ */
+template <int N> struct DTypeTag : DT<N> {
+    static constexpr int index = N;
+};
+
+/**
+ * @brief Call `f(DTypeTag<N>{})` where N is `dtype.getIndex()`.
+ *
+ * A constexpr jump table indexed by DataType::getIndex is built once per
+ * (list, functor) pair, so the call costs one indirect branch instead of a
+ * chain of comparisons. DataTypes outside the list halt as unsupported.
+ */
+template <int N0, int... Ns, typename F>
+auto dispatchDType(DTypeList<N0, Ns...>, DataType dtype, F &&f) {
+    using Fn = std::remove_reference_t<F>;
+    using R = decltype(f(DTypeTag<N0>{}));
+    using Entry = R (*)(Fn &);
+    constexpr size_t tableSize = DTypeList<N0, Ns...>::maxIndex + 1;
+    static constexpr std::array<Entry, tableSize> table = [] {
+        std::array<Entry, tableSize> ret{};
+        ret[N0] = [](Fn &fn) -> R { return fn(DTypeTag<N0>{}); };
+        ((ret[Ns] = [](Fn &fn) -> R { return fn(DTypeTag<Ns>{}); }), ...);
+        return ret;
+    }();
+    int index = dtype.getIndex();
+    IT_ASSERT(index >= 0 && (size_t)index < tableSize && table[index],
+              "Unsupported data type " + dtype.toString());
+    return table[index](f);
+}
+
+template <typename List, typename F> auto dispatchDType(DataType dtype, F &&f) {
+    return dispatchDType(List{}, dtype, std::forward<F>(f));
+}
+
 } // namespace infini
@@ -0,0 +1,90 @@
+#pragma once
+#include "core/common.h"
+#include "core/ref.h"
+#include <mutex>
+
+namespace infini
+{
+    class Allocator;
+    class RuntimeObj;
+    using Runtime = Ref<RuntimeObj>;
+
+    /**
+     * @brief Per-execution state of a graph: an activation arena with the
+     * layout planned by the graph's allocator. While an ExecutionScope of the
+     * context is active on a thread, tensors placed in that allocator's arena
+     * resolve to the context's arena instead, so several threads can run the
+     * same graph at once, each in its own context. Tensors bound outside the
+     * arena, e.g. weights, are shared.
+     */
+    class ExecutionContextObj
+    {
+        Runtime runtime;
+        const Allocator *arena;
+        size_t bytes;
+        char *ptr;
+
+        static inline thread_local const ExecutionContextObj *current = nullptr;
+        friend class ExecutionScope;
+
+    public:
+        ExecutionContextObj(Runtime runtime, const Allocator *arena,
+                            size_t bytes);
+        ExecutionContextObj(const ExecutionContextObj &) = delete;
+        ExecutionContextObj &operator=(const ExecutionContextObj &) = delete;
+        ~ExecutionContextObj();
+
+        const Allocator *getArena() const { return arena; }
+        size_t getBytes() const { return bytes; }
+        char *getBase() const { return ptr; }
+
+        // the context of the innermost active scope on this thread
+        static const ExecutionContextObj *getCurrent() { return current; }
+    };
+    using ExecutionContext = Ref<ExecutionContextObj>;
+
+    /**
+     * @brief Make a context current on this thread for the lifetime of the
+     * scope. Scopes nest.
+     */
+    class ExecutionScope
+    {
+        const ExecutionContextObj *previous;
+
+    public:
+        explicit ExecutionScope(const ExecutionContext &context)
+            : ExecutionScope(context.get()) {}
+        // a null context makes shared tensors resolve to their own blobs
+        explicit ExecutionScope(const ExecutionContextObj *context)
+            : previous(ExecutionContextObj::current)
+        {
+            ExecutionContextObj::current = context;
+        }
+        ExecutionScope(const ExecutionScope &) = delete;
+        ~ExecutionScope() { ExecutionContextObj::current = previous; }
+    };
+
+    /**
+     * @brief Pool of the execution contexts of one arena. A context goes back
+     * to the pool when its last Ref is dropped.
+     */
+    class ContextPool : public std::enable_shared_from_this<ContextPool>
+    {
+        Runtime runtime;
+        const Allocator *arena;
+        std::mutex mutex;
+        vector<std::unique_ptr<ExecutionContextObj>> idle;
+
+    public:
+        ContextPool(Runtime runtime, const Allocator *arena)
+            : runtime(runtime), arena(arena) {}
+
+        /**
+         * @brief Take an idle context of at least `bytes`, or create one.
+         * Smaller idle contexts are left from an earlier plan and dropped.
+         */
+        ExecutionContext acquire(size_t bytes);
+        size_t idleCount();
+    };
+
+} // namespace infini
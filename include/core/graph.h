@@ -18,10 +18,13 @@ namespace infini
         TensorVec tensors;
         OpVec ops;
         Allocator allocator;
+        Ref<ContextPool> contextPool;
 
     public:
         explicit GraphObj(Runtime runtime)
-            : runtime(runtime), allocator(runtime), sorted(false){};
+            : runtime(runtime), allocator(runtime),
+              contextPool(make_ref<ContextPool>(runtime, &allocator)),
+              sorted(false){};
         string toString() const override;
         Runtime getRuntime() const { return runtime; }
 
@@ -89,6 +92,54 @@ namespace infini
         void shape_infer();
 
         void dataMalloc();
+        // bytes of the activation arena planned by dataMalloc
+        size_t getArenaBytes() const { return allocator.getPeak(); }
+        /**
+         * @brief Write the allocations, frees and in-place reuses simulated
+         * by dataMalloc, with their op step, tensor, offset and size, and the
+         * blocks live at the high-water mark. The format is CSV if path ends
+         * in .csv and JSON otherwise.
+         */
+        void saveMemoryTimeline(const string &path) const;
+        const vector<Allocator::Event> &getMemoryTimeline() const
+        {
+            return allocator.getTimeline();
+        }
+
+        /**
+         * @brief Take a pooled execution context with its own activation
+         * arena for the planned graph. Run the graph and access its inputs
+         * and outputs within an ExecutionScope of the context; the ops,
+         * weights and plan are shared by all contexts. Weights must be bound
+         * before dataMalloc to be shared, data written to arena tensors
+         * outside of a scope is not seen by contexts.
+         */
+        ExecutionContext acquireContext()
+        {
+            IT_ASSERT(allocator.getBasePtr() != nullptr,
+                      "acquireContext requires a planned graph");
+            return contextPool->acquire(allocator.getPeak());
+        }
+
+        /**
+         * @brief Prepare the graph for execution with topo_sort, optimize,
+         * shape_infer and dataMalloc. If planFile holds a plan saved for the
+         * same graph and runtime by a build with the same kernels and
+         * planning rules, the plan is applied instead and all the passes are
+         * skipped. Otherwise the passes run and the plan is saved
+         * to planFile. An empty planFile only runs the passes.
+         * Applying a plan rebuilds the operators, so only tensor handles stay
+         * valid.
+         * @return true if a plan was applied.
+         */
+        bool compile(const string &planFile = "");
+
+        /**
+         * @brief Save the plan of a compiled graph: op order, tensor shapes
+         * and offsets, arena size and the tuned kernels of its ops. Call it
+         * again after a tuning run to persist the tuning results.
+         */
+        void savePlan(const string &planFile) const;
 
         /**
          * @brief Add an operator and create its outputs. Output tensor arguments
@@ -150,6 +201,16 @@ namespace infini
          */
         bool sorted;
 
+        /**
+         * @brief Key of the graph as built and of the runtime, and the index
+         * of each tensor in the graph as built. Set by compile.
+         */
+        string planKey;
+        std::unordered_map<const TensorObj *, size_t> planTensorIds;
+
+        string computePlanKey() const;
+        bool loadPlan(const string &planFile);
+
         /**
          * @brief Add check function for inverse transpose
          */
@@ -179,6 +240,14 @@ namespace infini
          * @brief Clean up unused tensors
          */
         void cleanupUnusedTensors();
+
+        /**
+         * @brief Find concats whose inputs can be placed directly inside the
+         * output, i.e. all dimensions before the concat axis are 1. Returns the
+         * output and the byte offset of each such input.
+         */
+        std::unordered_map<TensorObj *, std::pair<TensorObj *, size_t>>
+        planConcatSlices() const;
     };
 
 } // namespace infini
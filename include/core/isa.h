@@ -0,0 +1,32 @@
+#pragma once
+#include "core/common.h"
+
+namespace infini
+{
+    /**
+     * @brief Instruction set levels a CPU kernel variant can be built for.
+     * Levels are ordered, a host supporting one level supports all lower ones.
+     */
+    enum class IsaLevel
+    {
+        Generic = 0,
+        SSE42,
+        AVX2, // AVX2 + FMA
+        AVX512, // AVX-512F
+    };
+
+    const char *isaLevelToString(IsaLevel isa);
+
+    /**
+     * @brief Highest level supported by the host, detected once through CPUID.
+     */
+    IsaLevel getHostIsaLevel();
+
+    /**
+     * @brief Host level capped by the INFINI_CPU_ISA environment variable
+     * (generic, sse4.2, avx2 or avx512). An override above the host level is
+     * ignored.
+     */
+    IsaLevel getActiveIsaLevel();
+
+} // namespace infini
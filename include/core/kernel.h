@@ -21,6 +21,13 @@ namespace infini
          */
         virtual void compute(const Operator &op,
                              const RuntimeObj *context) const = 0;
+
+        /**
+         * @brief Whether this kernel can (or should, as a heuristic) compute
+         * the op. Kernels which are not applicable are skipped during kernel
+         * selection and tuning.
+         */
+        virtual bool isApplicable(const Operator &op) const { return true; }
     };
 
     class KernelRegistry
@@ -30,7 +37,8 @@ namespace infini
             tuple<Kernel *const, const string, const int>; // Kernel, name, ID
 
     private:
-        std::map<KernelAttrs, KernelRecord> kernels;
+        // Several kernels may share a key, they are kept in registration order.
+        std::multimap<KernelAttrs, KernelRecord> kernels;
         int nKernels = 0;
 
     public:
@@ -46,22 +54,65 @@ namespace infini
         }
         bool registerKernel(const KernelAttrs &key, Kernel *kernel, string name)
         {
-            IT_ASSERT(kernels.find(key) == kernels.end(),
-                      "Kernel already registered");
+            for (auto &[k, v] : kernels)
+                IT_ASSERT(std::get<1>(v) != name,
+                          "Kernel " + name + " already registered");
             kernels.emplace(key, KernelRecord{kernel, name, ++nKernels});
             return true;
         }
+        /**
+         * @brief Get the default kernel for a (Device, OpType), i.e. the first
+         * registered variant with the highest ISA level not above the level in
+         * kernelAttrs.
+         */
         Kernel *getKernel(const KernelAttrs &kernelAttrs) const
         {
-            auto it = kernels.find(kernelAttrs);
-            IT_ASSERT(it != kernels.end(), "Kernel not found for key {" +
+            return std::get<0>(getKernelItem(kernelAttrs));
+        }
+        const KernelRecord &getKernelItem(const KernelAttrs &kernelAttrs) const
+        {
+            auto candidates = getKernelCandidates(kernelAttrs);
+            IT_ASSERT(!candidates.empty(), "Kernel not found for key {" +
                                                get_kernel_attrs_str(kernelAttrs) +
                                                "}");
-            return std::get<0>(it->second);
+            return *candidates.front();
         }
-        const KernelRecord &getKernelItem(const KernelAttrs &kernelAttrs) const
+        /**
+         * @brief All kernels for a (Device, OpType) with an ISA level not above
+         * the level in kernelAttrs, ordered by ISA level (highest first) and
+         * then by registration order. If op is given, kernels which are not
+         * applicable to it are left out.
+         */
+        vector<const KernelRecord *>
+        getKernelCandidates(const KernelAttrs &kernelAttrs,
+                            const Operator &op = nullptr) const
         {
-            return kernels.at(kernelAttrs);
+            vector<const KernelRecord *> ret;
+            auto [device, opType, maxIsa] = kernelAttrs;
+            for (int isa = (int)maxIsa; isa >= (int)IsaLevel::Generic; --isa)
+            {
+                auto [begin, end] =
+                    kernels.equal_range(KernelAttrs{device, opType, (IsaLevel)isa});
+                for (auto it = begin; it != end; ++it)
+                    if (!op || std::get<0>(it->second)->isApplicable(op))
+                        ret.emplace_back(&it->second);
+            }
+            return ret;
+        }
+        // every registered kernel, ordered by key and registration
+        vector<std::pair<KernelAttrs, const KernelRecord *>> getAllKernels() const
+        {
+            vector<std::pair<KernelAttrs, const KernelRecord *>> ret;
+            for (auto &[k, v] : kernels)
+                ret.emplace_back(k, &v);
+            return ret;
+        }
+        const KernelRecord *getKernelItemByName(const string &name) const
+        {
+            for (auto &[k, v] : kernels)
+                if (std::get<1>(v) == name)
+                    return &v;
+            return nullptr;
         }
     };
 
@@ -74,14 +125,17 @@ namespace infini
 
 } // namespace infini
 
-#define _REGISTER_KERNEL_1(device, opType, kernel, name, cnt)                 \
+#define _REGISTER_KERNEL_1(device, opType, isa, kernel, name, cnt)            \
     namespace infini                                                          \
     {                                                                         \
         static const bool _CAT(_register_kernel_, cnt) =                      \
-            KernelRegistry::getInstance().registerKernel(KernelAttrs{device,  \
-                                                                     opType}, \
-                                                         new kernel(), name); \
+            KernelRegistry::getInstance().registerKernel(                     \
+                KernelAttrs{device, opType, isa}, new kernel(), name);        \
     }
 
 #define REGISTER_KERNEL(device, opType, kernel, name) \
-    _REGISTER_KERNEL_1(device, opType, kernel, name, __COUNTER__)
+    _REGISTER_KERNEL_1(device, opType, IsaLevel::Generic, kernel, name, __COUNTER__)
+
+// Register a variant that is only selected on hosts supporting `isa`.
+#define REGISTER_KERNEL_ISA(device, opType, isa, kernel, name) \
+    _REGISTER_KERNEL_1(device, opType, isa, kernel, name, __COUNTER__)
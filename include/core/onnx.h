@@ -0,0 +1,42 @@
+#pragma once
+#include "core/graph.h"
+#include <map>
+
+namespace infini
+{
+    /**
+     * @brief A graph imported from an ONNX model. Inputs and outputs are kept
+     * with their ONNX names, in the order of the model.
+     */
+    struct OnnxModel
+    {
+        Graph graph;
+        vector<std::pair<string, Tensor>> inputs, outputs;
+
+        Tensor getInput(const string &name) const;
+        Tensor getOutput(const string &name) const;
+    };
+
+    /**
+     * @brief Import an ONNX model file. The protobuf encoding is decoded by a
+     * built-in wire-format reader, no ONNX or protobuf library is needed.
+     *
+     * Supported nodes: Add, Sub, Mul, Div, Relu, Sigmoid, Tanh, Exp, Log,
+     * Erf, Gelu (without approximation), Softmax, LogSoftmax (on the last
+     * axis before opset 13), LayerNormalization and RMSNormalization (Y
+     * output only), ReduceSum, ReduceMean, ReduceMax, ReduceMin and
+     * ReduceProd (axes as an attribute or an initializer, without
+     * noop_with_empty_axes), Clip, Cast, Concat, Transpose, MatMul, Gemm
+     * (with alpha and beta equal to 1) and Identity.
+     * Symbolic dims of the graph inputs are resolved from dimParams.
+     *
+     * Initializers in raw_data, inline or in external data files, are bound
+     * to the mapped files without copying when they are aligned to their
+     * element size; the others are decoded into buffers of their own. The
+     * mappings are private copy-on-write. dataMalloc leaves initializers out
+     * of the arena.
+     */
+    OnnxModel loadOnnx(Runtime runtime, const string &path,
+                       const std::map<string, int> &dimParams = {});
+
+} // namespace infini
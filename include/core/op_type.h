@@ -24,6 +24,24 @@ namespace infini
             Relu,
             Sub,
             Transpose,
+            // appended after the first set so that saved plans keep their
+            // numbers
+            Erf,
+            Exp,
+            Gelu,
+            Log,
+            Sigmoid,
+            Silu,
+            Tanh,
+            Softmax,
+            LogSoftmax,
+            LayerNorm,
+            RMSNorm,
+            ReduceSum,
+            ReduceMean,
+            ReduceMax,
+            ReduceMin,
+            ReduceProd,
 
         } type;
 
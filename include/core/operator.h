@@ -1,11 +1,12 @@
 #pragma once
 
+#include "core/isa.h"
 #include "core/op_type.h"
 #include "core/tensor.h"
 
 namespace infini
 {
-    using KernelAttrs = std::tuple<Device, OpType::underlying_t>;
+    using KernelAttrs = std::tuple<Device, OpType::underlying_t, IsaLevel>;
 
     class GraphObj;
     class OperatorObj : public Object
@@ -55,6 +56,35 @@ namespace infini
         virtual int numInputs() const = 0;
         virtual int numOutputs() const = 0;
 
+        /**
+         * @brief Attributes which, together with the input shapes, decide how
+         * the op is computed, e.g. the permutation of Transpose.
+         */
+        virtual vector<int> getOpAttrVector() const { return {}; }
+        /**
+         * @brief A string identifying the workload of this op: type, data
+         * type, input shapes and attributes. Ops with the same signature are
+         * interchangeable for kernel tuning.
+         */
+        string getOpSignature() const;
+        /**
+         * @brief Whether the output may share the buffer of an input with the
+         * same shape and data type. Every kernel of such an op must read an
+         * element of that input before writing the same element of the output.
+         */
+        virtual bool supportsInplace() const { return false; }
+        /**
+         * @brief Arithmetic operations of one execution, computed from the
+         * shapes. Ops which only move data, like Transpose and Concat, have
+         * none.
+         */
+        virtual double getFlops() const { return 0; }
+        /**
+         * @brief Bytes one execution moves at least: each distinct input is
+         * read once and each output is written once.
+         */
+        virtual double getMinBytes() const;
+
         /**
          * @brief Clone this operator and replace its inputs and outputs.
          *
@@ -0,0 +1,51 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini
+{
+    /**
+     * @brief Stores the kernel chosen by tuning for each op signature, see
+     * OperatorObj::getOpSignature. Records can be persisted in a tuning file
+     * so that later processes skip tuning. If INFINI_TUNING_FILE is set, the
+     * file is loaded on first use and rewritten after new records are added by
+     * a tuning run.
+     */
+    class PerfEngine
+    {
+    public:
+        // <kernel attrs string + op signature, kernel name>
+        using Records = std::map<string, string>;
+
+    private:
+        Records records;
+        string tuningFile;
+
+    public:
+        PerfEngine();
+        static PerfEngine &getInstance()
+        {
+            static PerfEngine instance;
+            return instance;
+        }
+
+        /**
+         * @brief Record key of an op: its kernel attrs and op signature.
+         */
+        static string getKey(const KernelAttrs &kernelAttrs, const Operator &op);
+
+        optional<string> getRecord(const string &key) const;
+        void setRecord(const string &key, const string &kernelName);
+        const Records &getRecords() const { return records; }
+        void clear() { records.clear(); }
+
+        /**
+         * @brief Merge the records of a tuning file, existing keys are
+         * overwritten. Returns false if the file cannot be opened.
+         */
+        bool load(const string &path);
+        void save(const string &path) const;
+        // Save to INFINI_TUNING_FILE, if it is set.
+        void saveTuningFile() const;
+    };
+
+} // namespace infini
@@ -0,0 +1,80 @@
+#pragma once
+#include "core/execution.h"
+#include "core/graph.h"
+#include "core/spsc_queue.h"
+#include <future>
+
+namespace infini
+{
+    struct PipelineOptions
+    {
+        int nStages = 2;
+        // cores of each stage, by default the cores the process may run on
+        // are split evenly
+        vector<vector<int>> stageCpus;
+        // micro-batches which may wait between two stages
+        size_t queueDepth = 4;
+    };
+
+    /**
+     * @brief Pipeline-parallel execution of a planned graph. The topo-sorted
+     * ops are cut into stages of balanced profiled cost, each stage runs on a
+     * thread pinned to its cores, and micro-batches, each in an execution
+     * context of its own, stream through the stages over lock-free SPSC
+     * queues. The kernels of a stage run their parallel loops on a team of
+     * the stage's own, pinned to the same cores, instead of the runtime's.
+     *
+     * submit and the destructor must be called from the same thread.
+     */
+    class PipelineExecutor
+    {
+    public:
+        PipelineExecutor(Graph graph, TensorVec outputs,
+                         PipelineOptions options = {});
+        PipelineExecutor(const PipelineExecutor &) = delete;
+        // finishes the submitted micro-batches before returning
+        ~PipelineExecutor();
+
+        /**
+         * @brief Queue a micro-batch with the bytes of each input tensor.
+         * The future yields the bytes of each output tensor. Spins while the
+         * first stage's queue is full.
+         */
+        std::future<vector<vector<char>>>
+        submit(vector<std::pair<Tensor, vector<char>>> inputs);
+
+        const vector<OpVec> &getStages() const { return stages; }
+
+        /**
+         * @brief Cut costs into at most nStages non-empty contiguous ranges
+         * so that the most expensive range is as cheap as possible. Returns
+         * the first index of every range.
+         */
+        static vector<size_t> partition(const vector<double> &costs,
+                                        int nStages);
+
+    private:
+        struct MicroBatch
+        {
+            // null for the end-of-stream marker
+            ExecutionContext context;
+            std::promise<vector<vector<char>>> result;
+            std::exception_ptr error;
+        };
+
+        Graph graph;
+        TensorVec outputs;
+        vector<OpVec> stages;
+        // queues[i] feeds stage i
+        vector<std::unique_ptr<SpscQueue<MicroBatch>>> queues;
+        // teams[i] runs the parallel loops of stage i
+        vector<std::unique_ptr<ParallelTeam>> teams;
+        vector<std::thread> threads;
+
+        vector<double> profile() const;
+        // end the stream and join the started stage threads
+        void stop();
+        void runStage(size_t stage);
+    };
+
+} // namespace infini
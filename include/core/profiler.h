@@ -0,0 +1,121 @@
+#pragma once
+#include "core/operator.h"
+#include <array>
+#include <chrono>
+#include <map>
+#include <mutex>
+
+namespace infini
+{
+    class CounterGroup;
+    class ParallelTeam;
+
+    /**
+     * @brief Peak rates of the host for the roofline: a STREAM triad
+     * bandwidth and the FMA throughput of the widest vectors the runtime may
+     * use, both on the runtime's thread team.
+     */
+    struct MachinePeak
+    {
+        double gbps = 0, gflops = 0;
+    };
+    // Measure the peak of a runtime's team, once per thread count.
+    MachinePeak probeMachinePeak(const RuntimeObj *runtime);
+
+    /**
+     * @brief Per-op profile of graph execution. Set it on a runtime with
+     * RuntimeObj::setProfiler and every kernel invocation is timed and
+     * attributed to its OpType and kernel name.
+     *
+     * Optionally, hardware counters (cycles, instructions, LLC misses and
+     * branch misses, user space only) are read with perf_event_open around
+     * each invocation. They are counted on the calling thread and the
+     * workers of the team the kernel runs on, so ops of runs overlapping on
+     * the same team are not told apart. Counters which the host or its
+     * perf_event_paranoid setting does not provide are left out.
+     */
+    class Profiler
+    {
+    public:
+        enum Counter
+        {
+            Cycles,
+            Instructions,
+            LlcMisses,
+            BranchMisses,
+            NCounters
+        };
+        using Counters = std::array<uint64_t, NCounters>;
+
+        struct Entry
+        {
+            string opType, kernel;
+            size_t calls = 0;
+            double ms = 0;
+            // arithmetic operations and minimum bytes moved of the
+            // invocations, see OperatorObj::getFlops and getMinBytes
+            double flops = 0, bytes = 0;
+            Counters counters{};
+        };
+        // the state when an op starts, see begin
+        struct Mark
+        {
+            std::chrono::steady_clock::time_point time;
+            Counters counters;
+            // the team whose workers are counted
+            const ParallelTeam *team = nullptr;
+        };
+
+        explicit Profiler(bool useCounters = true);
+        ~Profiler();
+
+        /**
+         * @brief Open the counters of the workers of the runtime's team, so
+         * that begin only reads them, and close those of other threads.
+         * Called by RuntimeObj::setProfiler and setParallelism; the teams of
+         * TeamScopes are opened on their first op.
+         */
+        void attach(const RuntimeObj *runtime) const;
+
+        // whether counter is recorded
+        bool hasCounter(Counter counter) const;
+        bool hasCounters() const { return available != 0; }
+
+        Mark begin(const RuntimeObj *runtime) const;
+        void end(const Mark &mark, const Operator &op, const string &kernel);
+
+        // entries by decreasing total time
+        vector<Entry> getEntries() const;
+        void clear();
+        /**
+         * @brief A table of the entries with their share of the time,
+         * bandwidth and, with counters, IPC, LLC misses per KB moved and
+         * branch misses per 1000 instructions.
+         */
+        string report() const;
+        /**
+         * @brief How far each entry is from the roofline of a machine: the
+         * attainable rate is the lower of the peak FLOP rate and the
+         * arithmetic intensity (FLOP per byte) times the peak bandwidth.
+         * Ops without arithmetic are compared with the peak bandwidth. The
+         * bandwidth is that of memory, ops working in cache can exceed it.
+         */
+        string roofline(const MachinePeak &peak) const;
+        string toJson() const;
+
+    private:
+        // bit i is set if counter i is recorded
+        unsigned available = 0;
+        mutable std::mutex mutex;
+        std::map<std::pair<string, string>, Entry> entries;
+        // the counters of team workers by thread id, those of the calling
+        // thread are thread local
+        mutable std::mutex groupsMutex;
+        mutable std::map<int, std::unique_ptr<CounterGroup>> workerGroups;
+
+        // requires groupsMutex
+        const CounterGroup &getWorkerCounters(int tid) const;
+        Counters readCounters(const ParallelTeam *team) const;
+    };
+
+} // namespace infini
@@ -1,7 +1,13 @@
 #pragma once
 #include "core/common.h"
+#include "core/isa.h"
 #include "core/op_type.h"
 #include "core/ref.h"
+#include "core/thread_pool.h"
+#include <algorithm>
+#include <future>
+#include <map>
+#include <unordered_map>
 
 namespace infini
 {
@@ -10,6 +16,8 @@ namespace infini
   class GraphObj;
   class RuntimeObj;
   class BlobObj;
+  class Kernel;
+  class Profiler;
 
   using Tensor = Ref<TensorObj>;
   using Operator = Ref<OperatorObj>;
@@ -29,30 +37,117 @@ namespace infini
   {
   protected:
     Device device;
+    Ref<Profiler> profiler;
+
+  private:
+    // the pool of runAsync, created on first use
+    mutable std::mutex poolMutex;
+    mutable std::unique_ptr<ThreadPool> pool;
+    size_t poolThreads = std::max(1u, std::thread::hardware_concurrency());
+    size_t poolMaxQueued = 2 * poolThreads;
+    // the team of parallelFor
+    std::unique_ptr<ParallelTeam> team;
 
   public:
     explicit RuntimeObj(Device device)
-        : device(device) {}
+        : device(device),
+          team(std::make_unique<ParallelTeam>(getDefaultThreadCount())) {}
     RuntimeObj(RuntimeObj &other) = delete;
     RuntimeObj &operator=(RuntimeObj const &) = delete;
-    virtual ~RuntimeObj() {}
+    virtual ~RuntimeObj();
+
+    /**
+     * @brief Execute the graph. If tune is true, ops with several applicable
+     * kernels and no tuning record are timed with every candidate and the
+     * fastest one is recorded in the PerfEngine.
+     */
+    virtual void run(const Graph &graph, bool tune = false) const = 0;
+    // Execute a part of a graph's operators in the given order.
+    virtual void runOps(const OpVec &ops, bool tune = false) const = 0;
 
-    virtual void run(const Graph &graph) const = 0;
+    /**
+     * @brief Run a planned graph on the runtime's thread pool, in an
+     * execution context of the graph so that requests on the same graph
+     * overlap. inputs holds the bytes of each input tensor; the future
+     * yields the bytes of each tensor in outputs. Blocks while the pool's
+     * queue is full, so do not call it from a task of the pool.
+     *
+     * graph must belong to this runtime. A queued request holds the graph
+     * and so the runtime, the caller may drop its own Refs before the
+     * future is ready.
+     */
+    std::future<vector<vector<char>>>
+    runAsync(const Graph &graph,
+             vector<std::pair<Tensor, vector<char>>> inputs,
+             TensorVec outputs) const;
+    /**
+     * @brief Set the number of threads and the queue depth of the pool of
+     * runAsync. Must be called before the first runAsync.
+     */
+    void setAsyncPool(size_t nThreads, size_t maxQueued);
+
+    /**
+     * @brief Data-parallel loop for kernels on the runtime's thread team, or
+     * on the team of an active TeamScope, see ParallelTeam::parallelFor.
+     * The body sees the caller's ExecutionContext on every member thread.
+     */
+    void parallelFor(size_t begin, size_t end, size_t grain,
+                     const std::function<void(size_t, size_t)> &fn) const
+    {
+      getTeam()->parallelFor(begin, end, grain, fn);
+    }
+    /**
+     * @brief Replace the thread team of the runtime, optionally pinning its
+     * members to cpus. Must not be called while the runtime is running, so
+     * that several runtimes can split the cores of a host.
+     */
+    void setParallelism(size_t nThreads, vector<int> cpus = {});
+    size_t getThreadCount() const { return getTeam()->getThreadCount(); }
+    /**
+     * @brief Record every kernel invocation of later runs in profiler, or
+     * stop profiling if it is null. Must not be called while the runtime is
+     * running.
+     */
+    void setProfiler(Ref<Profiler> profiler_);
+    const Ref<Profiler> &getProfiler() const { return profiler; }
+    const vector<int> &getTeamCpus() const { return getTeam()->getCpus(); }
+    // the team of the active TeamScope if any, else the runtime's
+    ParallelTeam *getTeam() const
+    {
+      auto current = ParallelTeam::getCurrent();
+      return current ? current : team.get();
+    }
+    /**
+     * @brief INFINI_NUM_THREADS if set, otherwise the number of cores the
+     * process may run on.
+     */
+    static size_t getDefaultThreadCount();
+    // Allocate zeroed memory.
     virtual void *alloc(size_t size) = 0;
+    // Allocate memory of unspecified content, for callers which write every
+    // byte before reading it.
+    virtual void *allocUninitialized(size_t size) { return alloc(size); }
     virtual void dealloc(void *ptr) = 0;
 
     bool isCpu() const
     {
       return true;
     }
+    Device getDevice() const { return device; }
+    // highest ISA level of the kernel variants this runtime may pick
+    virtual IsaLevel getIsaLevel() const { return IsaLevel::Generic; }
 
     virtual string toString() const = 0;
   };
 
   class NativeCpuRuntimeObj : public RuntimeObj
   {
+    // highest ISA level of the kernel variants this runtime may pick
+    IsaLevel isa;
+
   public:
-    NativeCpuRuntimeObj() : RuntimeObj(Device::CPU) {}
+    NativeCpuRuntimeObj()
+        : RuntimeObj(Device::CPU), isa(getActiveIsaLevel()) {}
 
     static Ref<NativeCpuRuntimeObj> &getInstance()
     {
@@ -61,9 +156,54 @@ namespace infini
       return instance;
     }
     void dealloc(void *ptr) override;
-    void run(const Graph &graph) const override;
+    void run(const Graph &graph, bool tune = false) const override;
+    void runOps(const OpVec &ops, bool tune = false) const override;
     void *alloc(size_t size) override;
+    void *allocUninitialized(size_t size) override;
     string toString() const override;
+
+    IsaLevel getIsaLevel() const override { return isa; }
+    void setIsaLevel(IsaLevel isa_) { isa = std::min(isa_, getHostIsaLevel()); }
+
+    struct CacheStats
+    {
+        size_t cachedBytes, cachedBuffers, hits, misses;
+    };
+    /**
+     * @brief Limit the bytes of released mapped buffers kept for reuse by
+     * later arenas and execution contexts. 0 disables the cache. The default
+     * is INFINI_ALLOC_CACHE_BYTES if set, otherwise 1 GiB.
+     */
+    void setCacheLimit(size_t bytes);
+    CacheStats getCacheStats();
+    ~NativeCpuRuntimeObj();
+
+  private:
+    // sizes of the live buffers allocated with mmap, by address
+    std::mutex mappingMutex;
+    std::unordered_map<void *, size_t> mappings;
+    // released mapped buffers by size
+    std::multimap<size_t, void *> cache;
+    size_t cachedBytes = 0, cacheLimit = getDefaultCacheLimit();
+    size_t cacheHits = 0, cacheMisses = 0;
+
+    static size_t getDefaultCacheLimit();
+    void *allocImpl(size_t size, bool zero);
+    // map a large buffer, see allocImpl
+    void *allocMapped(size_t size);
+    // take a cached buffer of about bytes, or nullptr
+    void *takeCached(size_t bytes);
+    // unmap cached buffers until at most limit bytes are cached
+    void evictCache(size_t limit);
+
+    /**
+     * @brief Pick the kernel for op: the only applicable one, the tuned one
+     * if there is a record, the fastest one if tune is true, or else the
+     * first applicable one. Sets tuned if a new record is added. Tuning
+     * restores the inputs of op which share a buffer with its outputs.
+     */
+    const std::tuple<Kernel *const, const string, const int> &
+    selectKernel(const Operator &op, bool tune, bool &tuned) const;
   };
 
 } // namespace infini
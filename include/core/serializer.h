@@ -0,0 +1,70 @@
+#pragma once
+#include "core/graph.h"
+
+namespace infini
+{
+    /**
+     * @brief Binary graph file, version 1. All integers are little-endian.
+     *
+     * header:  magic "ITGRAPH\0", u32 version, u32 reserved, u64 metaBytes,
+     *          u64 payloadOffset
+     * meta:    u64 nTensors, tensor records, u64 nOps, op records
+     * tensor:  i32 dtype, u32 rank, i32 dims[rank], u8 hasPayload,
+     *          u64 payload offset relative to payloadOffset, u64 payload bytes
+     * op:      u16 opType, u32 nInputs, u32 inputs[], u32 nOutputs,
+     *          u32 outputs[], u32 nInts, i32 ints[], u32 nFloats, f32 floats[]
+     * payload: tensor data, every tensor starting on a 64-byte boundary of
+     *          the file
+     *
+     * Tensors are referred to by their index in the tensor records.
+     */
+    constexpr uint32_t graphFileVersion = 1;
+    constexpr size_t graphFileAlignment = 64;
+
+    /**
+     * @brief A whole file mapped private copy-on-write, unmapped when the
+     * object is destroyed. Blobs bound to the mapping keep a Ref to it.
+     */
+    class MappedFile
+    {
+        void *ptr;
+        size_t size;
+
+    public:
+        explicit MappedFile(const string &path);
+        MappedFile(const MappedFile &) = delete;
+        ~MappedFile();
+        char *data() const { return static_cast<char *>(ptr); }
+        size_t getSize() const { return size; }
+    };
+
+    /**
+     * @brief Get the attributes of a saveable operator as integers and floats.
+     */
+    void getOpAttrs(const Operator &op, vector<int> &ints,
+                    vector<float> &floats);
+
+    /**
+     * @brief Add an operator with its outputs specified from the attributes
+     * returned by getOpAttrs.
+     */
+    void addOpFromAttrs(GraphObj *g, OpType type, const TensorVec &inputs,
+                        const TensorVec &outputs, const vector<int> &ints,
+                        const vector<float> &floats);
+
+    /**
+     * @brief Save the tensors and operators of a graph. The data of the
+     * tensors in `weights`, which must be bound, is stored as payload.
+     */
+    void saveGraph(const Graph &graph, const string &path,
+                   const TensorVec &weights = {});
+
+    /**
+     * @brief Load a graph saved by saveGraph. The file is mapped into memory
+     * and tensors with payload are bound to the mapped pages without copying,
+     * so dataMalloc leaves them out of the arena. The pages are private
+     * copy-on-write, writing the tensors does not change the file.
+     */
+    Graph loadGraph(Runtime runtime, const string &path);
+
+} // namespace infini
@@ -0,0 +1,61 @@
+#pragma once
+#include "core/common.h"
+#include <atomic>
+#include <optional>
+#include <thread>
+
+namespace infini
+{
+    /**
+     * @brief Lock-free bounded queue for exactly one producer thread and one
+     * consumer thread. The capacity is rounded up to a power of two.
+     */
+    template <typename T>
+    class SpscQueue
+    {
+        vector<std::optional<T>> slots;
+        size_t mask;
+        // head is only written by the consumer and tail by the producer, on
+        // separate cache lines
+        alignas(64) std::atomic<size_t> head{0};
+        alignas(64) std::atomic<size_t> tail{0};
+
+    public:
+        explicit SpscQueue(size_t capacity)
+        {
+            size_t size = 1;
+            while (size < capacity)
+                size <<= 1;
+            slots.resize(size);
+            mask = size - 1;
+        }
+        SpscQueue(const SpscQueue &) = delete;
+
+        bool tryPush(T &value)
+        {
+            size_t t = tail.load(std::memory_order_relaxed);
+            if (t - head.load(std::memory_order_acquire) == slots.size())
+                return false;
+            slots[t & mask].emplace(std::move(value));
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+        // spins while the queue is full
+        void push(T value)
+        {
+            while (!tryPush(value))
+                std::this_thread::yield();
+        }
+        std::optional<T> tryPop()
+        {
+            size_t h = head.load(std::memory_order_relaxed);
+            if (h == tail.load(std::memory_order_acquire))
+                return std::nullopt;
+            std::optional<T> value = std::move(slots[h & mask]);
+            slots[h & mask].reset();
+            head.store(h + 1, std::memory_order_release);
+            return value;
+        }
+    };
+
+} // namespace infini
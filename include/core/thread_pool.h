@@ -0,0 +1,145 @@
+#pragma once
+#include "core/common.h"
+#include "core/execution.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace infini
+{
+    /**
+     * @brief A fixed set of worker threads running tasks in FIFO order. The
+     * number of queued tasks is bounded: submit blocks while the queue is
+     * full, which applies backpressure to the producer.
+     */
+    class ThreadPool
+    {
+    public:
+        ThreadPool(size_t nThreads, size_t maxQueued);
+        ThreadPool(const ThreadPool &) = delete;
+        // runs the queued tasks before returning
+        ~ThreadPool();
+
+        void submit(std::function<void()> task);
+        // queue the task unless the queue is full
+        bool trySubmit(std::function<void()> task);
+
+        size_t getThreadCount() const { return workers.size(); }
+        size_t getMaxQueued() const { return maxQueued; }
+        // whether the calling thread is one of the pool's workers
+        bool isWorker() const { return currentPool == this; }
+
+    private:
+        static inline thread_local const ThreadPool *currentPool = nullptr;
+
+        size_t maxQueued;
+        std::mutex mutex;
+        std::condition_variable notEmpty, notFull;
+        std::deque<std::function<void()>> tasks;
+        bool stopping = false;
+        vector<std::thread> workers;
+
+        void work();
+    };
+
+    /**
+     * @brief A team of threads for data-parallel loops in kernels. The
+     * calling thread takes part as member 0, so a team of one thread runs
+     * everything inline. Members may be pinned to cores, member i to
+     * cpus[i % cpus.size()].
+     *
+     * Members run their chunks in the ExecutionContext that is current on
+     * the calling thread, so loop bodies resolve tensors like the caller.
+     *
+     * One loop runs on the team at a time. A loop started while the team is
+     * busy, e.g. from another request's thread or from inside a loop body,
+     * runs inline on its calling thread instead of oversubscribing the cores.
+     */
+    class ParallelTeam
+    {
+    public:
+        explicit ParallelTeam(size_t nThreads, vector<int> cpus = {});
+        ParallelTeam(const ParallelTeam &) = delete;
+        ~ParallelTeam();
+
+        /**
+         * @brief Call fn(chunkBegin, chunkEnd) on disjoint chunks covering
+         * [begin, end). Chunks hold at least grain indices, except when the
+         * range is smaller, and are assigned statically: the same range and
+         * grain always give member i the same chunk, which keeps pages
+         * first-touched by a member local to it.
+         */
+        void parallelFor(size_t begin, size_t end, size_t grain,
+                         const std::function<void(size_t, size_t)> &fn);
+
+        size_t getThreadCount() const { return nThreads; }
+        const vector<int> &getCpus() const { return cpus; }
+        // kernel thread ids of members 1.., e.g. to count their events
+        const vector<int> &getWorkerTids() const { return tids; }
+
+        // the team of the innermost active TeamScope on this thread, or null
+        static ParallelTeam *getCurrent() { return current; }
+
+    private:
+        static inline thread_local ParallelTeam *current = nullptr;
+        friend class TeamScope;
+
+        size_t nThreads;
+        vector<int> cpus;
+        vector<int> tids;
+
+        // held by the thread running a loop on the team
+        std::mutex loopMutex;
+        std::mutex mutex;
+        std::condition_variable start, finish;
+        size_t generation = 0, pending = 0, started = 0;
+        bool stopping = false;
+        const std::function<void(size_t, size_t)> *job = nullptr;
+        const ExecutionContextObj *jobContext = nullptr;
+        size_t jobBegin = 0, jobEnd = 0, nChunks = 0;
+        std::exception_ptr error;
+        vector<std::thread> workers;
+
+        static inline thread_local bool inLoop = false;
+
+        void runChunk(size_t chunk);
+        void work(size_t member);
+    };
+
+    /**
+     * @brief Run the kernels called on this thread on a team other than
+     * their runtime's, for the lifetime of the scope, e.g. a team pinned to
+     * the cores of a pipeline stage. Scopes nest.
+     */
+    class TeamScope
+    {
+        ParallelTeam *previous;
+
+    public:
+        explicit TeamScope(ParallelTeam *team) : previous(ParallelTeam::current)
+        {
+            ParallelTeam::current = team;
+        }
+        TeamScope(const TeamScope &) = delete;
+        ~TeamScope() { ParallelTeam::current = previous; }
+    };
+
+    /**
+     * @brief Pin a thread to a set of cores.
+     */
+    void pinThread(std::thread &thread, const vector<int> &cpus);
+
+    /**
+     * @brief Check that cpus is a non-empty set of cores the process may run
+     * on, so that threads can be pinned to it.
+     */
+    void checkCpus(const vector<int> &cpus);
+
+    /**
+     * @brief The cores the calling process may run on.
+     */
+    vector<int> getAllowedCpus();
+
+} // namespace infini
@@ -28,6 +28,9 @@ namespace infini
     std::string toString() const override;
     int numInputs() const override { return 2; }
     int numOutputs() const override { return 1; }
+    bool supportsInplace() const override { return true; }
+    // one operation per element of the broadcast output
+    double getFlops() const override { return getOutput()->size(); }
     };
 
 #define DEFINE_ELEMENT_WISE_OBJ(prefix, type)                    \
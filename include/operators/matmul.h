@@ -47,6 +47,12 @@ namespace infini
 
         int numInputs() const override { return inputs.size(); }
         int numOutputs() const override { return 1; }
+        vector<int> getOpAttrVector() const override { return {transA, transB}; }
+        // a multiply and an add per k for each element of C, in every batch
+        double getFlops() const override
+        {
+            return 2. * getOutput()->size() * k;
+        }
 
         bool getTransA() const { return transA; }
         bool getTransB() const { return transB; }
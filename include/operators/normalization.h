@@ -0,0 +1,89 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini
+{
+  /**
+   * @brief Layer normalization over the trailing dims from axis,
+   * (x - mean) / sqrt(var + epsilon) * scale + bias, as onnx
+   * LayerNormalization with only the Y output.
+   *
+   */
+  class LayerNormObj : public OperatorObj
+  {
+  public:
+    /**
+     * @brief Construct a new LayerNorm object.
+     *
+     * @param graph The computation graph that this operator belongs to.
+     * @param input The input tensor.
+     * @param scale The scale, of the normalized trailing dims of input.
+     * @param bias The bias of the shape of scale, or nullptr.
+     * @param output The output tensor, of the shape of input.
+     * @param axis The first normalized dim, negative values count from the
+     * last dim.
+     * @param epsilon Added to the variance.
+     */
+    LayerNormObj(GraphObj *graph, Tensor input, Tensor scale, Tensor bias,
+                 Tensor output, int axis = -1, float epsilon = 1e-5);
+    OP_CLONE(LayerNormObj);
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+    std::string toString() const override;
+    int numInputs() const override { return inputs.size(); }
+    int numOutputs() const override { return 1; }
+    // every row is read before it is written
+    bool supportsInplace() const override { return true; }
+    int getAxis() const { return axis; }
+    float getEpsilon() const { return epsilon; }
+    bool hasBias() const { return inputs.size() == 3; }
+    vector<int> getOpAttrVector() const override { return {axis}; }
+    // the sums of x and of x^2, a subtraction, a scaling and the affine
+    // scale and bias per element
+    double getFlops() const override { return 6. * getOutput()->size(); }
+
+  private:
+    int axis;
+    float epsilon;
+  };
+
+  /**
+   * @brief Root mean square normalization over the trailing dims from axis,
+   * x / sqrt(mean(x^2) + epsilon) * scale, as onnx RMSNormalization.
+   *
+   */
+  class RMSNormObj : public OperatorObj
+  {
+  public:
+    /**
+     * @brief Construct a new RMSNorm object.
+     *
+     * @param graph The computation graph that this operator belongs to.
+     * @param input The input tensor.
+     * @param scale The scale, of the normalized trailing dims of input.
+     * @param output The output tensor, of the shape of input.
+     * @param axis The first normalized dim, negative values count from the
+     * last dim.
+     * @param epsilon Added to the mean square.
+     */
+    RMSNormObj(GraphObj *graph, Tensor input, Tensor scale, Tensor output,
+               int axis = -1, float epsilon = 1e-5);
+    OP_CLONE(RMSNormObj);
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+    std::string toString() const override;
+    int numInputs() const override { return 2; }
+    int numOutputs() const override { return 1; }
+    // every row is read before it is written
+    bool supportsInplace() const override { return true; }
+    int getAxis() const { return axis; }
+    float getEpsilon() const { return epsilon; }
+    vector<int> getOpAttrVector() const override { return {axis}; }
+    // the sum of x^2 and two scalings per element
+    double getFlops() const override { return 4. * getOutput()->size(); }
+
+  private:
+    int axis;
+    float epsilon;
+  };
+} // namespace infini
@@ -0,0 +1,62 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini
+{
+  /**
+   * @brief The base class of the reductions over a set of axes, as onnx
+   * ReduceSum, ReduceMean, ReduceMax, ReduceMin and ReduceProd.
+   *
+   */
+  class ReduceObj : public OperatorObj
+  {
+  public:
+    /**
+     * @brief Construct a new Reduce object.
+     *
+     * @param type Operator type.
+     * @param graph The computation graph that this operator belongs to.
+     * @param input The input tensor.
+     * @param output The output tensor.
+     * @param axes The reduced axes, negative values count from the last dim.
+     * nullopt or an empty list reduces every axis.
+     * @param keepDims Whether the reduced axes stay in the output with size
+     * 1.
+     */
+    ReduceObj(OpType type, GraphObj *graph, Tensor input, Tensor output,
+              const optional<vector<int>> &axes, bool keepDims);
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+    std::string toString() const override;
+    int numInputs() const override { return 1; }
+    int numOutputs() const override { return 1; }
+    // the sorted non-negative reduced axes
+    const vector<int> &getAxes() const { return axes; }
+    bool isReduced(int axis) const;
+    bool getKeepDims() const { return keepDims; }
+    vector<int> getOpAttrVector() const override;
+    // one combination per input element
+    double getFlops() const override { return getInputs(0)->size(); }
+
+  private:
+    vector<int> axes;
+    bool keepDims;
+  };
+
+#define DEFINE_REDUCE_OBJ(prefix, type)                                 \
+  class prefix##Obj : public ReduceObj                                  \
+  {                                                                     \
+  public:                                                               \
+    prefix##Obj(GraphObj *graph, Tensor input, Tensor output,           \
+                const optional<vector<int>> &axes = std::nullopt,       \
+                bool keepDims = true)                                   \
+        : ReduceObj(type, graph, input, output, axes, keepDims) {}      \
+    OP_CLONE(prefix##Obj);                                              \
+  };
+
+  DEFINE_REDUCE_OBJ(ReduceSum, OpType::ReduceSum)
+  DEFINE_REDUCE_OBJ(ReduceMean, OpType::ReduceMean)
+  DEFINE_REDUCE_OBJ(ReduceMax, OpType::ReduceMax)
+  DEFINE_REDUCE_OBJ(ReduceMin, OpType::ReduceMin)
+  DEFINE_REDUCE_OBJ(ReduceProd, OpType::ReduceProd)
+}; // namespace infini
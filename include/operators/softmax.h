@@ -0,0 +1,57 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini
+{
+  /**
+   * @brief Softmax along one axis, exp(x - max) / sum(exp(x - max)), as
+   * onnx Softmax since opset 13.
+   *
+   */
+  class SoftmaxObj : public OperatorObj
+  {
+  public:
+    /**
+     * @brief Construct a new Softmax object.
+     *
+     * @param graph The computation graph that this operator belongs to.
+     * @param input The input tensor.
+     * @param output The output tensor, of the shape of input.
+     * @param axis The axis to normalize, negative values count from the
+     * last dim.
+     */
+    SoftmaxObj(GraphObj *graph, Tensor input, Tensor output, int axis = -1);
+    OP_CLONE(SoftmaxObj);
+    optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+
+    std::string toString() const override;
+    int numInputs() const override { return 1; }
+    int numOutputs() const override { return 1; }
+    // every row is read before it is written
+    bool supportsInplace() const override { return true; }
+    int getAxis() const { return axis; }
+    vector<int> getOpAttrVector() const override { return {axis}; }
+    // a max, a subtraction, an exp, a sum and a scaling per element
+    double getFlops() const override { return 5. * getOutput()->size(); }
+
+  protected:
+    SoftmaxObj(OpType type, GraphObj *graph, Tensor input, Tensor output,
+               int axis);
+
+  private:
+    int axis;
+  };
+
+  /**
+   * @brief log(softmax(x)) along one axis, computed as
+   * x - max - log(sum(exp(x - max))).
+   *
+   */
+  class LogSoftmaxObj : public SoftmaxObj
+  {
+  public:
+    LogSoftmaxObj(GraphObj *graph, Tensor input, Tensor output, int axis = -1)
+        : SoftmaxObj(OpType::LogSoftmax, graph, input, output, axis) {}
+    OP_CLONE(LogSoftmaxObj);
+  };
+} // namespace infini
@@ -27,6 +27,7 @@ namespace infini
     int numInputs() const override { return 1; }
     int numOutputs() const override { return 1; }
     std::vector<int> getPermute() const { return transposePermute; }
+    vector<int> getOpAttrVector() const override { return transposePermute; }
 
   private:
     vector<int> transposePermute;
@@ -24,6 +24,8 @@ namespace infini
     std::string toString() const override;
     int numInputs() const override { return 1; }
     int numOutputs() const override { return 1; }
+    bool supportsInplace() const override { return true; }
+    double getFlops() const override { return getOutput()->size(); }
   };
 
   class ClipObj : public OperatorObj
@@ -39,6 +41,13 @@ namespace infini
     std::optional<float> getMax() const { return maxValue; };
     int numInputs() const override { return 1; }
     int numOutputs() const override { return 1; }
+    bool supportsInplace() const override { return true; }
+    // a comparison per bound and element
+    double getFlops() const override
+    {
+      return double(getOutput()->size()) *
+             (minValue.has_value() + maxValue.has_value());
+    }
 
   private:
     std::optional<float> minValue, maxValue;
@@ -100,5 +109,33 @@ namespace infini
     OP_CLONE(prefix##Obj);                                    \
   };
 
+// A unary operator computed with flops operations per element.
+#define DEFINE_UNARY_OBJ_FLOPS(prefix, type, flops)           \
+  class prefix##Obj : public UnaryObj                         \
+  {                                                           \
+  public:                                                     \
+    prefix##Obj(GraphObj *graph, Tensor input, Tensor output) \
+        : UnaryObj(type, graph, input, output) {}             \
+    OP_CLONE(prefix##Obj);                                    \
+    double getFlops() const override                          \
+    {                                                         \
+      return double(flops) * getOutput()->size();             \
+    }                                                         \
+  };
+
+  // The activations below count the operations of the vectorized
+  // approximations of src/kernels/cpu/transcendental_avx2.h, an FMA as two
+  // and both sides of a branchless select: exp reduces the argument and
+  // evaluates a degree 7 polynomial, the others build on it.
   DEFINE_UNARY_OBJ(Relu, OpType::Relu)
+  DEFINE_UNARY_OBJ_FLOPS(Erf, OpType::Erf, 56)
+  DEFINE_UNARY_OBJ_FLOPS(Exp, OpType::Exp, 24)
+  // GELU with the exact erf form, 0.5 * x * (1 + erf(x / sqrt(2))), and
+  // its negative tail through erfcx
+  DEFINE_UNARY_OBJ_FLOPS(Gelu, OpType::Gelu, 133)
+  DEFINE_UNARY_OBJ_FLOPS(Log, OpType::Log, 32)
+  DEFINE_UNARY_OBJ_FLOPS(Sigmoid, OpType::Sigmoid, 28)
+  // SiLU (swish), x * sigmoid(x)
+  DEFINE_UNARY_OBJ_FLOPS(Silu, OpType::Silu, 29)
+  DEFINE_UNARY_OBJ_FLOPS(Tanh, OpType::Tanh, 42)
 }; // namespace infini
@@ -1,4 +1,6 @@
 #include "core/allocator.h"
+#include <algorithm>
+#include <iterator>
 #include <utility>
 
 namespace infini
@@ -7,6 +9,7 @@ namespace infini
     {
         used = 0;
         peak = 0;
+        top = 0;
         ptr = nullptr;
 
         // 'alignment' defaults to sizeof(uint64_t), because it is the length of
@@ -23,7 +26,7 @@ namespace infini
         }
     }
 
-    size_t Allocator::alloc(size_t size)
+    size_t Allocator::alloc(size_t size, UidBaseType tensor)
     {
         IT_ASSERT(this->ptr == nullptr);
         // pad the size to the multiple of alignment
@@ -53,26 +56,26 @@ namespace infini
                 
                 // 更新使用统计
                 used += size;
-                if (used > peak) {
-                    peak = used;
-                }
+                record(Event::Alloc, tensor, block_addr, size);
                 
                 return block_addr;
             }
         }
         
-        // 如果没有找到合适的空闲块，需要扩展内存
-        // 这里简化处理，直接返回当前已使用的大小作为新地址
-        size_t new_addr = used;
+        // 如果没有找到合适的空闲块，从 arena 顶部扩展内存
+        // 空闲块不会与顶部相邻（free 时已归还给顶部），因此直接从 top 分配
+        size_t new_addr = top;
+        top += size;
         used += size;
-        if (used > peak) {
-            peak = used;
+        if (top > peak) {
+            peak = top;
         }
+        record(Event::Alloc, tensor, new_addr, size);
         
         return new_addr;
     }
 
-    void Allocator::free(size_t addr, size_t size)
+    void Allocator::free(size_t addr, size_t size, UidBaseType tensor)
     {
         IT_ASSERT(this->ptr == nullptr);
         size = getAlignedSize(size);
@@ -85,56 +88,91 @@ namespace infini
         free_blocks[addr] = size;
         
         // 尝试与相邻的空闲块合并
-        mergeAdjacentBlocks(addr, size);
+        mergeAdjacentBlocks(addr);
         
         // 更新使用统计
         used -= size;
+        record(Event::Free, tensor, addr, size);
+    }
+
+    void Allocator::reuse(size_t addr, size_t size, UidBaseType tensor)
+    {
+        record(Event::Reuse, tensor, addr, getAlignedSize(size));
+    }
+
+    void Allocator::record(Event::Kind kind, UidBaseType tensor, size_t addr,
+                           size_t size)
+    {
+        timeline.push_back({kind, step, tensor, addr, size, used, top});
+    }
+
+    vector<Allocator::Event> Allocator::getLiveBlocks(size_t index) const
+    {
+        // 按偏移记录存活的内存块，原地复用的块换成新的张量
+        std::map<size_t, Event> live;
+        for (size_t i = 0; i <= index && i < timeline.size(); ++i)
+        {
+            auto &event = timeline[i];
+            if (event.kind == Event::Free)
+                live.erase(event.offset);
+            else
+                live.insert_or_assign(event.offset, event);
+        }
+        vector<Event> ret;
+        for (auto &[offset, event] : live)
+            ret.emplace_back(event);
+        return ret;
     }
 
-    void *Allocator::getPtr()
+    void *Allocator::getPtr(bool zero)
     {
         if (this->ptr == nullptr)
         {
-            this->ptr = runtime->alloc(this->peak);
+            this->ptr = zero ? runtime->alloc(this->peak)
+                             : runtime->allocUninitialized(this->peak);
             printf("Allocator really alloc: %p %lu bytes\n", this->ptr, peak);
         }
         return this->ptr;
     }
 
+    void Allocator::setPeak(size_t size)
+    {
+        IT_ASSERT(this->ptr == nullptr);
+        this->peak = size;
+    }
+
     size_t Allocator::getAlignedSize(size_t size)
     {
         return ((size - 1) / this->alignment + 1) * this->alignment;
     }
 
-    void Allocator::mergeAdjacentBlocks(size_t addr, size_t size)
+    void Allocator::mergeAdjacentBlocks(size_t addr)
     {
-        // 查找前一个相邻的空闲块
-        auto prev_it = free_blocks.find(addr - 1);
-        if (prev_it != free_blocks.end()) {
-            // 找到前一个块，检查是否真的相邻
-            size_t prev_addr = prev_it->first;
-            size_t prev_size = prev_it->second;
-            
-            if (prev_addr + prev_size == addr) {
-                // 可以与前一个块合并
-                size_t new_size = prev_size + size;
-                free_blocks[prev_addr] = new_size;
-                free_blocks.erase(addr);  // 移除当前块
-                
-                // 更新参数，继续检查是否可以与后一个块合并
-                addr = prev_addr;
-                size = new_size;
+        auto it = free_blocks.find(addr);
+        IT_ASSERT(it != free_blocks.end());
+
+        // 与前一个相邻的空闲块合并
+        if (it != free_blocks.begin()) {
+            auto prev_it = std::prev(it);
+            if (prev_it->first + prev_it->second == it->first) {
+                prev_it->second += it->second;
+                free_blocks.erase(it);
+                it = prev_it;
             }
         }
         
-        // 查找后一个相邻的空闲块
-        auto next_it = free_blocks.find(addr + size);
-        if (next_it != free_blocks.end()) {
-            // 找到后一个块，可以合并
-            size_t next_size = next_it->second;
-            size_t new_size = size + next_size;
-            free_blocks[addr] = new_size;
-            free_blocks.erase(addr + size);  // 移除后一个块
+        // 与后一个相邻的空闲块合并
+        auto next_it = std::next(it);
+        if (next_it != free_blocks.end() &&
+            it->first + it->second == next_it->first) {
+            it->second += next_it->second;
+            free_blocks.erase(next_it);
+        }
+
+        // 位于 arena 末尾的空闲块归还给顶部
+        if (it->first + it->second == top) {
+            top = it->first;
+            free_blocks.erase(it);
         }
     }
 
@@ -142,5 +180,33 @@ namespace infini
     {
         std::cout << "Used memory: " << this->used
                   << ", peak memory: " << this->peak << std::endl;
+        if (timeline.empty())
+            return;
+
+        // 碎片：arena 顶部以下的空闲字节，取最严重的一次
+        size_t worst = 0;
+        for (size_t i = 1; i < timeline.size(); ++i)
+            if (timeline[i].top - timeline[i].used >
+                timeline[worst].top - timeline[worst].used)
+                worst = i;
+        auto &event = timeline[worst];
+        std::cout << "Worst fragmentation: " << event.top - event.used
+                  << " free bytes below " << event.top << " at step "
+                  << event.step << std::endl;
+
+        // 首次达到峰值时存活的张量，按大小列出最大的几个
+        size_t atPeak = 0;
+        while (atPeak + 1 < timeline.size() && timeline[atPeak].top < peak)
+            ++atPeak;
+        auto live = getLiveBlocks(atPeak);
+        std::sort(live.begin(), live.end(), [](const Event &a, const Event &b)
+                  { return a.size > b.size; });
+        std::cout << "Live at peak (step " << timeline[atPeak].step
+                  << "):";
+        size_t shown = std::min<size_t>(live.size(), 5);
+        for (size_t i = 0; i < shown; ++i)
+            std::cout << " tensor " << live[i].tensor << " " << live[i].size
+                      << " bytes" << (i + 1 < shown ? "," : "");
+        std::cout << std::endl;
     }
 }
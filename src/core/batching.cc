@@ -0,0 +1,134 @@
+#include "core/batching.h"
+#include <cstring>
+
+namespace infini
+{
+    // Bytes of one sample of a tensor batched along its first dimension.
+    static size_t sampleBytes(const Tensor &tensor, int batch)
+    {
+        IT_ASSERT(tensor->getRank() > 0 && tensor->getDims()[0] == batch,
+                  "Batched tensors must have the batch size as first dim");
+        return tensor->getBytes() / batch;
+    }
+
+    DynamicBatcher::DynamicBatcher(std::function<BatchBucket(int batch)> build,
+                                   BatchingOptions options_)
+        : options(std::move(options_))
+    {
+        IT_ASSERT(!options.buckets.empty(), "No batch size buckets");
+        for (int batch : options.buckets)
+        {
+            IT_ASSERT(batch > 0);
+            auto bucket = build(batch);
+            bucket.graph->compile();
+            vector<size_t> in, out;
+            for (auto &input : bucket.inputs)
+                in.emplace_back(sampleBytes(input, batch));
+            for (auto &output : bucket.outputs)
+                out.emplace_back(sampleBytes(output, batch));
+            if (buckets.empty())
+            {
+                inputBytes = in;
+                outputBytes = out;
+            }
+            IT_ASSERT(in == inputBytes && out == outputBytes,
+                      "Buckets differ in more than the batch size");
+            buckets.emplace(batch, std::move(bucket));
+        }
+        worker = std::thread([this] { serve(); });
+    }
+
+    DynamicBatcher::~DynamicBatcher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        worker.join();
+    }
+
+    std::future<SampleData> DynamicBatcher::submit(SampleData inputs)
+    {
+        IT_ASSERT(inputs.size() == inputBytes.size(),
+                  "Wrong number of inputs");
+        for (size_t i = 0; i < inputs.size(); ++i)
+            IT_ASSERT(inputs[i].size() == inputBytes[i],
+                      "Wrong size of input " + std::to_string(i));
+        Request request{std::move(inputs), {}, std::chrono::steady_clock::now()};
+        auto future = request.result.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            IT_ASSERT(!stopping, "The batcher is stopping");
+            queue.emplace_back(std::move(request));
+        }
+        cv.notify_one();
+        return future;
+    }
+
+    void DynamicBatcher::serve()
+    {
+        const size_t maxBatch = buckets.rbegin()->first;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            cv.wait(lock, [&] { return stopping || !queue.empty(); });
+            if (queue.empty())
+                return;
+            // wait for more requests until the batch is full or the oldest
+            // request times out; on stop the queue is drained at once
+            auto deadline = queue.front().arrival + options.timeout;
+            cv.wait_until(lock, deadline, [&] {
+                return stopping || queue.size() >= maxBatch;
+            });
+            vector<Request> batch;
+            while (!queue.empty() && batch.size() < maxBatch)
+            {
+                batch.emplace_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+            lock.unlock();
+            runBatch(batch);
+            lock.lock();
+        }
+    }
+
+    void DynamicBatcher::runBatch(vector<Request> &batch)
+    {
+        auto &bucket = buckets.lower_bound(int(batch.size()))->second;
+        vector<SampleData> results(batch.size());
+        try
+        {
+            for (size_t i = 0; i < bucket.inputs.size(); ++i)
+            {
+                auto dst = bucket.inputs[i]->getRawDataPtr<char *>();
+                for (size_t j = 0; j < batch.size(); ++j)
+                    std::memcpy(dst + j * inputBytes[i],
+                                batch[j].inputs[i].data(), inputBytes[i]);
+                // padding samples of a larger bucket are left as they are,
+                // their outputs are dropped
+            }
+            bucket.graph->getRuntime()->run(bucket.graph);
+            ++batchCount;
+            for (size_t j = 0; j < batch.size(); ++j)
+            {
+                results[j].resize(bucket.outputs.size());
+                for (size_t i = 0; i < bucket.outputs.size(); ++i)
+                {
+                    auto src = bucket.outputs[i]->getRawDataPtr<char *>() +
+                               j * outputBytes[i];
+                    results[j][i].assign(src, src + outputBytes[i]);
+                }
+            }
+        }
+        catch (...)
+        {
+            for (auto &request : batch)
+                request.result.set_exception(std::current_exception());
+            return;
+        }
+        for (size_t j = 0; j < batch.size(); ++j)
+            batch[j].result.set_value(std::move(results[j]));
+    }
+
+} // namespace infini
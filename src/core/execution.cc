@@ -0,0 +1,52 @@
+#include "core/execution.h"
+#include "core/runtime.h"
+
+namespace infini
+{
+    ExecutionContextObj::ExecutionContextObj(Runtime runtime,
+                                             const Allocator *arena,
+                                             size_t bytes)
+        : runtime(runtime), arena(arena), bytes(bytes)
+    {
+        ptr = static_cast<char *>(runtime->alloc(bytes));
+        IT_ASSERT(ptr != nullptr || bytes == 0,
+                  "Cannot allocate an execution context");
+    }
+
+    ExecutionContextObj::~ExecutionContextObj() { runtime->dealloc(ptr); }
+
+    ExecutionContext ContextPool::acquire(size_t bytes)
+    {
+        std::unique_ptr<ExecutionContextObj> context;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            while (!idle.empty() && !context)
+            {
+                if (idle.back()->getBytes() >= bytes)
+                    context = std::move(idle.back());
+                idle.pop_back();
+            }
+        }
+        if (!context)
+            context = std::make_unique<ExecutionContextObj>(runtime, arena,
+                                                            bytes);
+        WRef<ContextPool> pool = weak_from_this();
+        return ExecutionContext(
+            context.release(), [pool](ExecutionContextObj *context) {
+                if (auto self = pool.lock())
+                {
+                    std::lock_guard<std::mutex> lock(self->mutex);
+                    self->idle.emplace_back(context);
+                }
+                else
+                    delete context;
+            });
+    }
+
+    size_t ContextPool::idleCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return idle.size();
+    }
+
+} // namespace infini
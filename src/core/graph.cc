@@ -1,4 +1,5 @@
 #include "core/graph.h"
+#include "operators/concat.h"
 #include "operators/transpose.h"
 #include "operators/matmul.h"
 #include <algorithm>
@@ -234,51 +235,164 @@ namespace infini
         // HINT: 获取分配好的内存指针后，可以调用 tensor 的 setDataBlob 函数给 tensor 绑定内存
         // =================================== 作业 ===================================
         
-        // 第一阶段：收集所有tensor的内存需求并分配偏移
-        std::unordered_set<TensorObj*> allocated_tensors;
-        std::vector<std::pair<Tensor, size_t>> tensor_offsets;
-        
-        // 遍历所有tensor，分配内存偏移
+        // 拼接消除：<拼接的输入, <拼接的输出, 输入在输出中的字节偏移>>
+        auto slices = planConcatSlices();
+        std::unordered_set<TensorObj *> owners;
+        for (auto &[slice, owner] : slices)
+            owners.insert(owner.first);
+        // 切片与拼接输出共用拼接输出的内存块，生命周期按内存块统计
+        auto rootOf = [&](TensorObj *tensor)
+        {
+            auto it = slices.find(tensor);
+            return it == slices.end() ? tensor : it->second.first;
+        };
+
+        // 第一阶段：按拓扑序模拟执行，张量在生产者执行时分配，在最后一个消费者执行后释放
+        std::unordered_map<TensorObj *, size_t> offsets;
+        // 每个内存块剩余的消费次数（同一算子多次使用同一张量时计多次）
+        std::unordered_map<TensorObj *, int> remaining;
+        // 把内存块让给了原地执行的输出的张量，不再由自己释放
+        std::unordered_set<TensorObj *> donated;
+        for (auto &op : ops)
+            for (auto &input : op->getInputs())
+                ++remaining[rootOf(input.get())];
+        // 图的输出没有消费者，其内存块不能被释放
         for (auto &tensor : tensors)
+            if (tensor->getTargets().empty())
+                ++remaining[rootOf(tensor.get())];
+
+        // 图的输入（包括权重）没有生产者，先分配且不释放
+        // 已绑定外部内存的张量（如从图文件映射的权重）保留原有内存
+        std::unordered_set<TensorObj *> external;
+        for (auto &tensor : tensors)
+            if (!tensor->getSource())
+            {
+                if (tensor->hasData())
+                    external.insert(tensor.get());
+                else
+                    offsets[tensor.get()] =
+                        allocator.alloc(tensor->getBytes(), tensor->getGuid());
+            }
+
+        for (size_t step = 0; step < ops.size(); ++step)
         {
-            if (tensor && allocated_tensors.find(tensor.get()) == allocated_tensors.end())
+            auto &op = ops[step];
+            // 时间线中的事件按算子下标归属
+            allocator.setStep(step);
+            for (auto &output : op->getOutputs())
             {
-                // 计算tensor需要的内存大小
-                size_t tensor_size = tensor->getBytes();
-                
-                // 使用allocator分配内存地址偏移
-                size_t offset = allocator.alloc(tensor_size);
-                
-                // 保存tensor和偏移的对应关系
-                tensor_offsets.emplace_back(tensor, offset);
-                allocated_tensors.insert(tensor.get());
+                auto tensor = output.get();
+                if (auto it = slices.find(tensor); it != slices.end())
+                {
+                    // 生产者直接写入拼接输出中的切片，拼接输出随第一个切片分配
+                    auto owner = it->second.first;
+                    if (!offsets.count(owner))
+                        offsets[owner] =
+                            allocator.alloc(owner->getBytes(), owner->getGuid());
+                    offsets[tensor] = offsets[owner] + it->second.second;
+                    continue;
+                }
+                if (offsets.count(tensor))
+                    continue;
+
+                // 原地执行：输入是中间结果、形状和类型与输出相同、且当前算子是它的最后一个消费者
+                TensorObj *inplace = nullptr;
+                if (op->supportsInplace())
+                    for (auto &input : op->getInputs())
+                        if (input->getSource() && remaining[input.get()] == 1 &&
+                            !donated.count(input.get()) &&
+                            !slices.count(input.get()) && !owners.count(input.get()) &&
+                            input->getDims() == output->getDims() &&
+                            input->getDType() == output->getDType())
+                        {
+                            inplace = input.get();
+                            break;
+                        }
+
+                if (inplace)
+                {
+                    offsets[tensor] = offsets.at(inplace);
+                    donated.insert(inplace);
+                    allocator.reuse(offsets[tensor], output->getBytes(),
+                                    output->getGuid());
+                }
+                else
+                    offsets[tensor] =
+                        allocator.alloc(output->getBytes(), output->getGuid());
+            }
+            for (auto &input : op->getInputs())
+            {
+                auto root = rootOf(input.get());
+                if (--remaining[root] == 0 && root->getSource() &&
+                    !donated.count(root))
+                    allocator.free(offsets.at(root), root->getBytes(),
+                                   root->getGuid());
             }
         }
         
         // 第二阶段：获取实际内存指针并绑定到tensor
-        void *base_ptr = allocator.getPtr();
+        // 算子按拓扑序执行，每个中间结果都先由其生产者写入再被读取，
+        // 因此 arena 无需清零，只有图输入可能未写先读，绑定后单独清零
+        void *base_ptr = allocator.getPtr(false);
         if (base_ptr)
         {
-            for (const auto &pair : tensor_offsets)
+            for (auto &tensor : tensors)
             {
-                auto tensor = pair.first;
-                size_t offset = pair.second;
-                
-                // 计算实际的内存地址
+                if (external.count(tensor.get()))
+                    continue;
                 //char* 以字节为单位进行指针算术
-                void *tensor_ptr = static_cast<char*>(base_ptr) + offset;
-                
-                // 创建Blob对象
-                Blob blob = make_ref<BlobObj>(runtime, tensor_ptr);
+                void *tensor_ptr = static_cast<char*>(base_ptr) + offsets.at(tensor.get());
                 
                 // 绑定内存到tensor
-                tensor->setDataBlob(blob);
+                tensor->setDataBlob(make_ref<BlobObj>(
+                    runtime, tensor_ptr, &allocator, offsets.at(tensor.get())));
+                if (!tensor->getSource())
+                    std::memset(tensor_ptr, 0, tensor->getBytes());
             }
         }
         
         allocator.info();
     }
 
+    std::unordered_map<TensorObj *, std::pair<TensorObj *, size_t>>
+    GraphObj::planConcatSlices() const
+    {
+        std::unordered_map<TensorObj *, std::pair<TensorObj *, size_t>> slices;
+        std::unordered_set<TensorObj *> owners;
+        for (auto &op : ops)
+        {
+            if (op->getOpType() != OpType::Concat)
+                continue;
+            auto concat = as<ConcatObj>(op);
+            auto output = concat->getOutput().get();
+            // 拼接轴之前的维度都为 1 时，各输入在输出中是连续的切片
+            auto dims = output->getDims();
+            if (std::accumulate(dims.begin(), dims.begin() + concat->getDim(), 1,
+                                std::multiplies{}) != 1)
+                continue;
+            // 输入必须是只出现一次的中间结果，且不参与其他拼接消除
+            std::unordered_set<TensorObj *> seen;
+            bool eliminable = !slices.count(output);
+            for (auto &input : concat->getInputs())
+            {
+                auto tensor = input.get();
+                eliminable = eliminable && input->getSource() &&
+                             seen.insert(tensor).second &&
+                             !slices.count(tensor) && !owners.count(tensor);
+            }
+            if (!eliminable)
+                continue;
+            size_t offset = 0;
+            for (auto &input : concat->getInputs())
+            {
+                slices[input.get()] = {output, offset};
+                offset += input->getBytes();
+            }
+            owners.insert(output);
+        }
+        return slices;
+    }
+
     Tensor GraphObj::addTensor(Shape dim, DataType dtype)
     {
         return tensors.emplace_back(make_ref<TensorObj>(dim, dtype, runtime));
@@ -0,0 +1,67 @@
+#include "core/isa.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace infini
+{
+    const char *isaLevelToString(IsaLevel isa)
+    {
+        switch (isa)
+        {
+        case IsaLevel::Generic:
+            return "generic";
+        case IsaLevel::SSE42:
+            return "sse4.2";
+        case IsaLevel::AVX2:
+            return "avx2";
+        case IsaLevel::AVX512:
+            return "avx512";
+        default:
+            return "unknown";
+        }
+    }
+
+    static IsaLevel detectHostIsaLevel()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        // __builtin_cpu_supports reads CPUID and also checks that the OS saves
+        // the extended register state (XGETBV).
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+            return IsaLevel::AVX512;
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return IsaLevel::AVX2;
+        if (__builtin_cpu_supports("sse4.2"))
+            return IsaLevel::SSE42;
+#endif
+        return IsaLevel::Generic;
+    }
+
+    IsaLevel getHostIsaLevel()
+    {
+        static const IsaLevel host = detectHostIsaLevel();
+        return host;
+    }
+
+    static IsaLevel detectActiveIsaLevel()
+    {
+        auto host = getHostIsaLevel();
+        const char *env = std::getenv("INFINI_CPU_ISA");
+        if (env == nullptr || *env == '\0')
+            return host;
+        for (auto isa : {IsaLevel::Generic, IsaLevel::SSE42, IsaLevel::AVX2,
+                         IsaLevel::AVX512})
+        {
+            if (string(env) == isaLevelToString(isa))
+                return std::min(isa, host);
+        }
+        IT_TODO_HALT_MSG(string("Unknown INFINI_CPU_ISA value: ") + env);
+    }
+
+    IsaLevel getActiveIsaLevel()
+    {
+        static const IsaLevel active = detectActiveIsaLevel();
+        return active;
+    }
+
+} // namespace infini
@@ -0,0 +1,76 @@
+#include "core/graph.h"
+#include <fstream>
+
+namespace infini
+{
+    static const char *eventName(Allocator::Event::Kind kind)
+    {
+        switch (kind)
+        {
+        case Allocator::Event::Alloc:
+            return "alloc";
+        case Allocator::Event::Free:
+            return "free";
+        default:
+            return "reuse";
+        }
+    }
+
+    void GraphObj::saveMemoryTimeline(const string &path) const
+    {
+        auto &timeline = allocator.getTimeline();
+        IT_ASSERT(!timeline.empty(), "No memory timeline, call dataMalloc");
+        std::ofstream file(path);
+        IT_ASSERT(file.good(), "Cannot write " + path);
+        auto opName = [&](int step) -> string {
+            return step < 0 ? "input" : ops.at(step)->getOpType().toString();
+        };
+        bool csv = path.size() >= 4 && path.substr(path.size() - 4) == ".csv";
+        if (csv)
+        {
+            file << "event,step,op,tensor,offset,size,used,top\n";
+            for (auto &event : timeline)
+                file << eventName(event.kind) << "," << event.step << ","
+                     << opName(event.step) << "," << event.tensor << ","
+                     << event.offset << "," << event.size << "," << event.used
+                     << "," << event.top << "\n";
+            return;
+        }
+
+        // the event which first reached the high-water mark
+        size_t atPeak = 0;
+        for (size_t i = 0; i < timeline.size(); ++i)
+            if (timeline[i].top > timeline[atPeak].top)
+                atPeak = i;
+        file << "{\n  \"arena_bytes\": " << allocator.getPeak()
+             << ",\n  \"ops\": [";
+        for (size_t i = 0; i < ops.size(); ++i)
+            file << (i ? ", " : "") << "{\"step\": " << i << ", \"op\": \""
+                 << opName(i) << "\", \"guid\": " << ops[i]->getGuid() << "}";
+        file << "],\n  \"tensors\": [";
+        for (size_t i = 0; i < tensors.size(); ++i)
+            file << (i ? ", " : "") << "{\"guid\": " << tensors[i]->getGuid()
+                 << ", \"bytes\": " << tensors[i]->getBytes() << ", \"shape\": "
+                 << vecToString(tensors[i]->getDims()) << "}";
+        file << "],\n  \"events\": [";
+        for (size_t i = 0; i < timeline.size(); ++i)
+        {
+            auto &event = timeline[i];
+            file << (i ? ",\n    " : "\n    ") << "{\"event\": \""
+                 << eventName(event.kind) << "\", \"step\": " << event.step
+                 << ", \"tensor\": " << event.tensor
+                 << ", \"offset\": " << event.offset
+                 << ", \"size\": " << event.size << ", \"used\": " << event.used
+                 << ", \"top\": " << event.top << "}";
+        }
+        file << "\n  ],\n  \"peak\": {\"step\": " << timeline[atPeak].step
+             << ", \"top\": " << timeline[atPeak].top << ", \"live\": [";
+        auto live = allocator.getLiveBlocks(atPeak);
+        for (size_t i = 0; i < live.size(); ++i)
+            file << (i ? ", " : "") << "{\"tensor\": " << live[i].tensor
+                 << ", \"offset\": " << live[i].offset
+                 << ", \"size\": " << live[i].size << "}";
+        file << "]}\n}\n";
+    }
+
+} // namespace infini
@@ -0,0 +1,830 @@
+#include "core/onnx.h"
+#include "core/blob.h"
+#include "core/serializer.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/normalization.h"
+#include "operators/reduce.h"
+#include "operators/softmax.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+#include "utils/operator_utils.h"
+#include <cstring>
+
+namespace infini
+{
+    namespace
+    {
+        enum class WireType
+        {
+            Varint = 0,
+            Fixed64 = 1,
+            Bytes = 2,
+            Fixed32 = 5,
+        };
+
+        // A field of a protobuf message. Bytes fields point into the buffer
+        // being decoded.
+        struct Field
+        {
+            uint32_t number;
+            WireType wireType;
+            uint64_t value = 0;
+            const char *data = nullptr;
+            size_t size = 0;
+
+            string str() const { return string(data, size); }
+            float asFloat() const
+            {
+                uint32_t bits = value;
+                float ret;
+                std::memcpy(&ret, &bits, sizeof(ret));
+                return ret;
+            }
+        };
+
+        class ProtoReader
+        {
+            const char *ptr, *end;
+
+            uint64_t readVarint()
+            {
+                uint64_t value = 0;
+                for (int shift = 0; shift < 64; shift += 7)
+                {
+                    IT_ASSERT(ptr < end, "Truncated ONNX message");
+                    uint8_t byte = *ptr++;
+                    value |= uint64_t(byte & 0x7f) << shift;
+                    if (!(byte & 0x80))
+                        return value;
+                }
+                IT_TODO_HALT_MSG("Invalid varint in ONNX message");
+            }
+            uint64_t readFixed(size_t bytes)
+            {
+                IT_ASSERT(ptr + bytes <= end, "Truncated ONNX message");
+                uint64_t value = 0;
+                std::memcpy(&value, ptr, bytes);
+                ptr += bytes;
+                return value;
+            }
+
+        public:
+            ProtoReader(const char *data, size_t size)
+                : ptr(data), end(data + size) {}
+            explicit ProtoReader(const Field &field)
+                : ProtoReader(field.data, field.size) {}
+
+            bool next(Field &field)
+            {
+                if (ptr == end)
+                    return false;
+                auto key = readVarint();
+                field = Field{uint32_t(key >> 3), WireType(key & 7)};
+                switch (field.wireType)
+                {
+                case WireType::Varint:
+                    field.value = readVarint();
+                    break;
+                case WireType::Fixed64:
+                    field.value = readFixed(8);
+                    break;
+                case WireType::Fixed32:
+                    field.value = readFixed(4);
+                    break;
+                case WireType::Bytes:
+                    field.size = readVarint();
+                    IT_ASSERT(field.size <= size_t(end - ptr),
+                              "Truncated ONNX message");
+                    field.data = ptr;
+                    ptr += field.size;
+                    break;
+                default:
+                    IT_TODO_HALT_MSG("Unsupported wire type in ONNX message");
+                }
+                return true;
+            }
+
+            // Append the elements of a repeated scalar field, which may be
+            // packed into a Bytes field.
+            static void appendScalars(const Field &field, WireType type,
+                                      vector<uint64_t> &values)
+            {
+                if (field.wireType != WireType::Bytes)
+                {
+                    values.emplace_back(field.value);
+                    return;
+                }
+                ProtoReader packed(field);
+                while (packed.ptr != packed.end)
+                {
+                    if (type == WireType::Varint)
+                        values.emplace_back(packed.readVarint());
+                    else
+                        values.emplace_back(
+                            packed.readFixed(type == WireType::Fixed32 ? 4 : 8));
+                }
+            }
+        };
+
+        // Field numbers follow onnx/onnx.proto.
+        struct TensorProto
+        {
+            string name;
+            int dataType = 0;
+            vector<int64_t> dims;
+            const char *raw = nullptr;
+            size_t rawSize = 0;
+            // float_data, int32_data, int64_data, double_data or uint64_data,
+            // each element in the low bytes of a uint64_t
+            vector<uint64_t> values;
+            std::map<string, string> external;
+
+            explicit TensorProto(const Field &message)
+            {
+                ProtoReader reader(message);
+                Field field;
+                vector<uint64_t> rawDims;
+                while (reader.next(field))
+                {
+                    switch (field.number)
+                    {
+                    case 1:
+                        ProtoReader::appendScalars(field, WireType::Varint,
+                                                   rawDims);
+                        break;
+                    case 2:
+                        dataType = field.value;
+                        break;
+                    case 4:
+                        ProtoReader::appendScalars(field, WireType::Fixed32,
+                                                   values);
+                        break;
+                    case 5:
+                    case 7:
+                    case 11:
+                        ProtoReader::appendScalars(field, WireType::Varint,
+                                                   values);
+                        break;
+                    case 10:
+                        ProtoReader::appendScalars(field, WireType::Fixed64,
+                                                   values);
+                        break;
+                    case 8:
+                        name = field.str();
+                        break;
+                    case 9:
+                        raw = field.data;
+                        rawSize = field.size;
+                        break;
+                    case 13:
+                    {
+                        // StringStringEntryProto
+                        ProtoReader entry(field);
+                        Field kv;
+                        string key, value;
+                        while (entry.next(kv))
+                            (kv.number == 1 ? key : value) = kv.str();
+                        external[key] = value;
+                        break;
+                    }
+                    }
+                }
+                for (auto dim : rawDims)
+                    dims.emplace_back(dim);
+            }
+        };
+
+        struct AttributeProto
+        {
+            string name;
+            float f = 0;
+            int64_t i = 0;
+            string s;
+            vector<float> floats;
+            vector<int64_t> ints;
+
+            explicit AttributeProto(const Field &message)
+            {
+                ProtoReader reader(message);
+                Field field;
+                vector<uint64_t> rawFloats, rawInts;
+                while (reader.next(field))
+                {
+                    switch (field.number)
+                    {
+                    case 1:
+                        name = field.str();
+                        break;
+                    case 2:
+                        f = field.asFloat();
+                        break;
+                    case 3:
+                        i = field.value;
+                        break;
+                    case 4:
+                        s = field.str();
+                        break;
+                    case 7:
+                        ProtoReader::appendScalars(field, WireType::Fixed32,
+                                                   rawFloats);
+                        break;
+                    case 8:
+                        ProtoReader::appendScalars(field, WireType::Varint,
+                                                   rawInts);
+                        break;
+                    }
+                }
+                for (auto bits : rawFloats)
+                    floats.emplace_back(Field{0, WireType::Fixed32, bits}.asFloat());
+                for (auto value : rawInts)
+                    ints.emplace_back(value);
+            }
+        };
+
+        struct NodeProto
+        {
+            vector<string> inputs, outputs;
+            string name, opType;
+            std::map<string, AttributeProto> attrs;
+
+            explicit NodeProto(const Field &message)
+            {
+                ProtoReader reader(message);
+                Field field;
+                while (reader.next(field))
+                {
+                    switch (field.number)
+                    {
+                    case 1:
+                        inputs.emplace_back(field.str());
+                        break;
+                    case 2:
+                        outputs.emplace_back(field.str());
+                        break;
+                    case 3:
+                        name = field.str();
+                        break;
+                    case 4:
+                        opType = field.str();
+                        break;
+                    case 5:
+                    {
+                        AttributeProto attr(field);
+                        attrs.emplace(attr.name, attr);
+                        break;
+                    }
+                    }
+                }
+            }
+
+            bool hasAttr(const string &attr) const { return attrs.count(attr); }
+            int64_t getInt(const string &attr, int64_t defaultValue) const
+            {
+                auto it = attrs.find(attr);
+                return it == attrs.end() ? defaultValue : it->second.i;
+            }
+            float getFloat(const string &attr, float defaultValue) const
+            {
+                auto it = attrs.find(attr);
+                return it == attrs.end() ? defaultValue : it->second.f;
+            }
+            string getString(const string &attr,
+                             const string &defaultValue) const
+            {
+                auto it = attrs.find(attr);
+                return it == attrs.end() ? defaultValue : it->second.s;
+            }
+        };
+
+        struct ValueInfoProto
+        {
+            string name;
+            int elemType = 0;
+            vector<int64_t> dims;
+            // the symbolic name of each dim, empty for fixed dims
+            vector<string> params;
+
+            explicit ValueInfoProto(const Field &message)
+            {
+                ProtoReader reader(message);
+                Field field;
+                while (reader.next(field))
+                {
+                    if (field.number == 1)
+                        name = field.str();
+                    else if (field.number == 2)
+                        readType(field);
+                }
+            }
+
+        private:
+            // TypeProto.tensor_type -> elem_type, shape.dim
+            void readType(const Field &type)
+            {
+                ProtoReader typeReader(type);
+                Field tensorType;
+                while (typeReader.next(tensorType))
+                {
+                    if (tensorType.number != 1)
+                        continue;
+                    ProtoReader tensorReader(tensorType);
+                    Field field;
+                    while (tensorReader.next(field))
+                    {
+                        if (field.number == 1)
+                            elemType = field.value;
+                        else if (field.number == 2)
+                            readShape(field);
+                    }
+                }
+            }
+            void readShape(const Field &shape)
+            {
+                ProtoReader shapeReader(shape);
+                Field dim;
+                while (shapeReader.next(dim))
+                {
+                    if (dim.number != 1)
+                        continue;
+                    dims.emplace_back(-1);
+                    params.emplace_back();
+                    ProtoReader dimReader(dim);
+                    Field field;
+                    while (dimReader.next(field))
+                    {
+                        if (field.number == 1)
+                            dims.back() = field.value;
+                        else if (field.number == 2)
+                            params.back() = field.str();
+                    }
+                }
+            }
+        };
+
+        struct GraphProto
+        {
+            vector<NodeProto> nodes;
+            vector<TensorProto> initializers;
+            vector<ValueInfoProto> inputs, outputs;
+
+            explicit GraphProto(const Field &message)
+            {
+                ProtoReader reader(message);
+                Field field;
+                while (reader.next(field))
+                {
+                    switch (field.number)
+                    {
+                    case 1:
+                        nodes.emplace_back(field);
+                        break;
+                    case 5:
+                        initializers.emplace_back(field);
+                        break;
+                    case 11:
+                        inputs.emplace_back(field);
+                        break;
+                    case 12:
+                        outputs.emplace_back(field);
+                        break;
+                    }
+                }
+            }
+        };
+
+        // The ONNX TensorProto.DataType values are the DataType indices.
+        DataType toDataType(int onnxType)
+        {
+            IT_ASSERT(onnxType > 0 && onnxType != DataType::String.getIndex() &&
+                          (onnxType <= DataType::UInt64.getIndex() ||
+                           onnxType == DataType::BFloat16.getIndex()),
+                      "Unsupported ONNX data type " + std::to_string(onnxType));
+            return DataType(onnxType);
+        }
+
+        CastType toCastType(DataType from, DataType to)
+        {
+            // in the order of CastType
+            static const std::pair<DataType, DataType> casts[] = {
+                {DataType::Float32, DataType::Float16},
+                {DataType::Float32, DataType::Int64},
+                {DataType::Float32, DataType::Int32},
+                {DataType::Float32, DataType::Int16},
+                {DataType::Float32, DataType::Int8},
+                {DataType::Float32, DataType::BFloat16},
+                {DataType::Int32, DataType::Float32},
+                {DataType::Int32, DataType::Int8},
+                {DataType::Int32, DataType::Int16},
+                {DataType::Int32, DataType::Int64},
+                {DataType::Int16, DataType::Float32},
+                {DataType::Int16, DataType::Int32},
+                {DataType::Int8, DataType::Float32},
+                {DataType::Int8, DataType::Int16},
+                {DataType::Int8, DataType::Int32},
+                {DataType::UInt8, DataType::Float32},
+                {DataType::UInt8, DataType::Int32},
+                {DataType::UInt8, DataType::Int64},
+                {DataType::Int64, DataType::Int32},
+                {DataType::Int64, DataType::UInt32},
+                {DataType::Int64, DataType::Float32},
+                {DataType::UInt32, DataType::Int64},
+                {DataType::Float16, DataType::Float32},
+                {DataType::BFloat16, DataType::Float32},
+                {DataType::Float32, DataType::Float32},
+            };
+            for (size_t i = 0; i < std::size(casts); ++i)
+                if (casts[i].first == from && casts[i].second == to)
+                    return CastType(i);
+            IT_TODO_HALT_MSG("Unsupported Cast from " + from.toString() +
+                             " to " + to.toString());
+        }
+
+        class OnnxImporter
+        {
+            Runtime runtime;
+            string dir;
+            Ref<MappedFile> model;
+            std::map<string, Ref<MappedFile>> externalFiles;
+            OnnxModel result;
+            std::unordered_map<string, Tensor> values;
+            // version of the default operator set
+            int64_t opset = 0;
+
+        public:
+            OnnxImporter(Runtime runtime, const string &path)
+                : runtime(runtime), model(make_ref<MappedFile>(path))
+            {
+                auto slash = path.rfind('/');
+                dir = slash == string::npos ? "" : path.substr(0, slash + 1);
+                result.graph = make_ref<GraphObj>(runtime);
+            }
+
+            OnnxModel import(const std::map<string, int> &dimParams)
+            {
+                // ModelProto.graph and ModelProto.opset_import
+                ProtoReader reader(model->data(), model->getSize());
+                Field field;
+                std::optional<GraphProto> graph;
+                while (reader.next(field))
+                    if (field.number == 7)
+                        graph.emplace(field);
+                    else if (field.number == 8)
+                    {
+                        ProtoReader opsetReader(field);
+                        Field opsetField;
+                        string domain;
+                        int64_t version = 0;
+                        while (opsetReader.next(opsetField))
+                            if (opsetField.number == 1)
+                                domain = opsetField.str();
+                            else if (opsetField.number == 2)
+                                version = opsetField.value;
+                        if (domain.empty() || domain == "ai.onnx")
+                            opset = version;
+                    }
+                IT_ASSERT(graph.has_value(), "ONNX model has no graph");
+
+                for (auto &init : graph->initializers)
+                    values[init.name] = addInitializer(init);
+                for (auto &input : graph->inputs)
+                {
+                    // older models also list initializers as inputs
+                    if (values.count(input.name))
+                        continue;
+                    Shape shape;
+                    for (size_t i = 0; i < input.dims.size(); ++i)
+                    {
+                        if (input.params[i].empty())
+                        {
+                            IT_ASSERT(input.dims[i] >= 0);
+                            shape.emplace_back(input.dims[i]);
+                            continue;
+                        }
+                        auto it = dimParams.find(input.params[i]);
+                        IT_ASSERT(it != dimParams.end(),
+                                  "No value for dim " + input.params[i] +
+                                      " of input " + input.name);
+                        shape.emplace_back(it->second);
+                    }
+                    auto tensor = result.graph->addTensor(
+                        shape, toDataType(input.elemType));
+                    values[input.name] = tensor;
+                    result.inputs.emplace_back(input.name, tensor);
+                }
+                for (auto &node : graph->nodes)
+                    addNode(node);
+                for (auto &output : graph->outputs)
+                    result.outputs.emplace_back(output.name,
+                                                getValue(output.name));
+                return result;
+            }
+
+        private:
+            Tensor getValue(const string &name) const
+            {
+                auto it = values.find(name);
+                IT_ASSERT(it != values.end(), "Undefined ONNX value " + name);
+                return it->second;
+            }
+
+            // A constant input given as an initializer, e.g. the bounds of
+            // Clip.
+            float getScalar(const string &name) const
+            {
+                auto tensor = getValue(name);
+                IT_ASSERT(tensor->hasData() &&
+                              tensor->getDType() == DataType::Float32 &&
+                              tensor->size() == 1,
+                          name + " must be a float scalar initializer");
+                return *tensor->getRawDataPtr<float *>();
+            }
+
+            // A constant Int64 input given as an initializer, e.g. the axes
+            // of reductions.
+            vector<int> getInts(const string &name) const
+            {
+                auto tensor = getValue(name);
+                IT_ASSERT(tensor->hasData() &&
+                              tensor->getDType() == DataType::Int64 &&
+                              tensor->getRank() <= 1,
+                          name + " must be an int64 vector initializer");
+                auto data = tensor->getRawDataPtr<int64_t *>();
+                return vector<int>(data, data + tensor->size());
+            }
+
+            Tensor addInitializer(const TensorProto &init)
+            {
+                Shape shape(init.dims.begin(), init.dims.end());
+                auto tensor =
+                    result.graph->addTensor(shape, toDataType(init.dataType));
+                size_t bytes = tensor->getBytes();
+                const char *data = init.raw;
+                size_t dataSize = init.rawSize;
+                Ref<void> storage = model;
+                if (!init.external.empty())
+                {
+                    auto &file = externalFiles[init.external.at("location")];
+                    if (!file)
+                        file = make_ref<MappedFile>(
+                            dir + init.external.at("location"));
+                    size_t offset = init.external.count("offset")
+                                        ? std::stoull(init.external.at("offset"))
+                                        : 0;
+                    IT_ASSERT(offset <= file->getSize(),
+                              "Invalid external data of " + init.name);
+                    dataSize = init.external.count("length")
+                                   ? std::stoull(init.external.at("length"))
+                                   : file->getSize() - offset;
+                    IT_ASSERT(offset + dataSize <= file->getSize(),
+                              "Invalid external data of " + init.name);
+                    data = file->data() + offset;
+                    storage = file;
+                }
+
+                if (data)
+                {
+                    IT_ASSERT(dataSize == bytes,
+                              "Size mismatch of initializer " + init.name);
+                    // the mappings are writable, so the data is used in place
+                    // when it is aligned
+                    if (reinterpret_cast<uintptr_t>(data) %
+                            tensor->getDType().getSize() ==
+                        0)
+                    {
+                        tensor->setDataBlob(make_ref<BlobObj>(
+                            runtime, const_cast<char *>(data), storage));
+                        return tensor;
+                    }
+                }
+                auto buffer = std::make_shared<vector<char>>(bytes);
+                if (data)
+                    std::memcpy(buffer->data(), data, bytes);
+                else
+                {
+                    IT_ASSERT(init.values.size() == tensor->size(),
+                              "Size mismatch of initializer " + init.name);
+                    // typed fields hold the elements in their low bytes
+                    size_t elemSize = tensor->getDType().getSize();
+                    for (size_t i = 0; i < init.values.size(); ++i)
+                        std::memcpy(buffer->data() + i * elemSize,
+                                    &init.values[i], elemSize);
+                }
+                tensor->setDataBlob(
+                    make_ref<BlobObj>(runtime, buffer->data(), buffer));
+                return tensor;
+            }
+
+            void addNode(const NodeProto &node)
+            {
+                auto g = result.graph;
+                TensorVec inputs;
+                for (auto &name : node.inputs)
+                    inputs.emplace_back(name.empty() ? nullptr : getValue(name));
+                auto input = [&](size_t i) {
+                    IT_ASSERT(i < inputs.size() && inputs[i],
+                              node.opType + " " + node.name + " misses input " +
+                                  std::to_string(i));
+                    return inputs[i];
+                };
+                auto optionalInput = [&](size_t i) {
+                    return i < inputs.size() ? inputs[i] : nullptr;
+                };
+
+                Tensor output;
+                const auto &type = node.opType;
+                if (type == "Add")
+                    output = g->addOp<AddObj>(input(0), input(1), nullptr)
+                                 ->getOutput();
+                else if (type == "Sub")
+                    output = g->addOp<SubObj>(input(0), input(1), nullptr)
+                                 ->getOutput();
+                else if (type == "Mul")
+                    output = g->addOp<MulObj>(input(0), input(1), nullptr)
+                                 ->getOutput();
+                else if (type == "Div")
+                    output = g->addOp<DivObj>(input(0), input(1), nullptr)
+                                 ->getOutput();
+                else if (type == "Relu")
+                    output = g->addOp<ReluObj>(input(0), nullptr)->getOutput();
+                else if (type == "Sigmoid")
+                    output =
+                        g->addOp<SigmoidObj>(input(0), nullptr)->getOutput();
+                else if (type == "Tanh")
+                    output = g->addOp<TanhObj>(input(0), nullptr)->getOutput();
+                else if (type == "Exp")
+                    output = g->addOp<ExpObj>(input(0), nullptr)->getOutput();
+                else if (type == "Log")
+                    output = g->addOp<LogObj>(input(0), nullptr)->getOutput();
+                else if (type == "Erf")
+                    output = g->addOp<ErfObj>(input(0), nullptr)->getOutput();
+                else if (type == "Gelu")
+                {
+                    IT_ASSERT(node.getString("approximate", "none") == "none",
+                              "Gelu with the tanh approximation is not supported");
+                    output = g->addOp<GeluObj>(input(0), nullptr)->getOutput();
+                }
+                else if (type == "Identity")
+                    output = input(0);
+                else if (type == "Clip")
+                {
+                    // min and max are attributes before opset 11 and optional
+                    // inputs since
+                    std::optional<float> min, max;
+                    if (node.hasAttr("min"))
+                        min = node.getFloat("min", 0);
+                    if (node.hasAttr("max"))
+                        max = node.getFloat("max", 0);
+                    if (optionalInput(1))
+                        min = getScalar(node.inputs[1]);
+                    if (optionalInput(2))
+                        max = getScalar(node.inputs[2]);
+                    output = g->addOp<ClipObj>(input(0), nullptr, min, max)
+                                 ->getOutput();
+                }
+                else if (type == "Cast")
+                {
+                    auto to = toDataType(node.getInt("to", 0));
+                    auto castType = toCastType(input(0)->getDType(), to);
+                    output = g->addOp<CastObj>(input(0), nullptr, castType)
+                                 ->getOutput();
+                }
+                else if (type == "Softmax" || type == "LogSoftmax")
+                {
+                    // before opset 13 the input is coerced to 2D at axis, which
+                    // is only the same as normalizing the last axis
+                    int rank = input(0)->getRank();
+                    int axis = node.getInt("axis", opset >= 13 ? -1 : 1);
+                    IT_ASSERT(opset >= 13 ||
+                                  get_real_axis(axis, rank) == rank - 1,
+                              type + " before opset 13 is only supported on "
+                                     "the last axis");
+                    if (type == "Softmax")
+                        output = g->addOp<SoftmaxObj>(input(0), nullptr, axis)
+                                     ->getOutput();
+                    else
+                        output =
+                            g->addOp<LogSoftmaxObj>(input(0), nullptr, axis)
+                                ->getOutput();
+                }
+                else if (type == "LayerNormalization")
+                    output = g->addOp<LayerNormObj>(
+                                  input(0), input(1), optionalInput(2), nullptr,
+                                  node.getInt("axis", -1),
+                                  node.getFloat("epsilon", 1e-5))
+                                 ->getOutput();
+                // SimplifiedLayerNormalization is the onnxruntime name of
+                // RMSNormalization
+                else if (type == "RMSNormalization" ||
+                         type == "SimplifiedLayerNormalization")
+                    output = g->addOp<RMSNormObj>(input(0), input(1), nullptr,
+                                                  node.getInt("axis", -1),
+                                                  node.getFloat("epsilon", 1e-5))
+                                 ->getOutput();
+                else if (type == "ReduceSum" || type == "ReduceMean" ||
+                         type == "ReduceMax" || type == "ReduceMin" ||
+                         type == "ReduceProd")
+                {
+                    // axes are an attribute before opset 18 (13 for
+                    // ReduceSum) and an optional input since
+                    vector<int> axes;
+                    if (node.hasAttr("axes"))
+                        axes.assign(node.attrs.at("axes").ints.begin(),
+                                    node.attrs.at("axes").ints.end());
+                    if (optionalInput(1))
+                        axes = getInts(node.inputs[1]);
+                    IT_ASSERT(!axes.empty() ||
+                                  !node.getInt("noop_with_empty_axes", 0),
+                              type + " with noop_with_empty_axes is not "
+                                     "supported");
+                    bool keepDims = node.getInt("keepdims", 1);
+                    Operator op;
+                    if (type == "ReduceSum")
+                        op = g->addOp<ReduceSumObj>(input(0), nullptr, axes,
+                                                    keepDims);
+                    else if (type == "ReduceMean")
+                        op = g->addOp<ReduceMeanObj>(input(0), nullptr, axes,
+                                                     keepDims);
+                    else if (type == "ReduceMax")
+                        op = g->addOp<ReduceMaxObj>(input(0), nullptr, axes,
+                                                    keepDims);
+                    else if (type == "ReduceMin")
+                        op = g->addOp<ReduceMinObj>(input(0), nullptr, axes,
+                                                    keepDims);
+                    else
+                        op = g->addOp<ReduceProdObj>(input(0), nullptr, axes,
+                                                     keepDims);
+                    output = op->getOutput();
+                }
+                else if (type == "Concat")
+                {
+                    IT_ASSERT(node.hasAttr("axis"), "Concat needs an axis");
+                    output = g->addOp<ConcatObj>(inputs, nullptr,
+                                                 node.getInt("axis", 0))
+                                 ->getOutput();
+                }
+                else if (type == "Transpose")
+                {
+                    // the default permutation reverses the dims
+                    vector<int> perm;
+                    if (node.hasAttr("perm"))
+                        perm.assign(node.attrs.at("perm").ints.begin(),
+                                    node.attrs.at("perm").ints.end());
+                    else
+                        for (int i = input(0)->getRank() - 1; i >= 0; --i)
+                            perm.emplace_back(i);
+                    output = g->addOp<TransposeObj>(input(0), nullptr, perm)
+                                 ->getOutput();
+                }
+                else if (type == "MatMul")
+                    output = g->addOp<MatmulObj>(input(0), input(1), nullptr)
+                                 ->getOutput();
+                else if (type == "Gemm")
+                {
+                    // Y = alpha * A' * B' + beta * C
+                    IT_ASSERT(node.getFloat("alpha", 1) == 1 &&
+                                  (!optionalInput(2) ||
+                                   node.getFloat("beta", 1) == 1),
+                              "Gemm is only supported with alpha = beta = 1");
+                    output = g->addOp<MatmulObj>(input(0), input(1), nullptr,
+                                                 node.getInt("transA", 0),
+                                                 node.getInt("transB", 0))
+                                 ->getOutput();
+                    if (optionalInput(2))
+                        output = g->addOp<AddObj>(output, input(2), nullptr)
+                                     ->getOutput();
+                }
+                else
+                    IT_TODO_HALT_MSG("Unsupported ONNX operator " + type);
+
+                IT_ASSERT(node.outputs.size() == 1,
+                          type + " " + node.name + " must have one output");
+                values[node.outputs[0]] = output;
+            }
+        };
+    } // namespace
+
+    Tensor OnnxModel::getInput(const string &name) const
+    {
+        for (auto &[inputName, tensor] : inputs)
+            if (inputName == name)
+                return tensor;
+        IT_TODO_HALT_MSG("No input named " + name);
+    }
+
+    Tensor OnnxModel::getOutput(const string &name) const
+    {
+        for (auto &[outputName, tensor] : outputs)
+            if (outputName == name)
+                return tensor;
+        IT_TODO_HALT_MSG("No output named " + name);
+    }
+
+    OnnxModel loadOnnx(Runtime runtime, const string &path,
+                       const std::map<string, int> &dimParams)
+    {
+        return OnnxImporter(runtime, path).import(dimParams);
+    }
+
+} // namespace infini
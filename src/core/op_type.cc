@@ -21,6 +21,22 @@ namespace infini
             CASE(Transpose);
             CASE(Concat);
             CASE(MatMul);
+            CASE(Erf);
+            CASE(Exp);
+            CASE(Gelu);
+            CASE(Log);
+            CASE(Sigmoid);
+            CASE(Silu);
+            CASE(Tanh);
+            CASE(Softmax);
+            CASE(LogSoftmax);
+            CASE(LayerNorm);
+            CASE(RMSNorm);
+            CASE(ReduceSum);
+            CASE(ReduceMean);
+            CASE(ReduceMax);
+            CASE(ReduceMin);
+            CASE(ReduceProd);
 
         default:
             return "Unknown";
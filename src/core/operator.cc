@@ -1,5 +1,6 @@
 #include "core/operator.h"
 #include "core/graph.h"
+#include <unordered_set>
 
 namespace infini
 {
@@ -72,6 +73,28 @@ namespace infini
 
     optional<vector<Shape>> OperatorObj::inferShape() { return inferShape(inputs); }
 
+    string OperatorObj::getOpSignature() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "|" << getDType().toString() << "|";
+        for (auto &input : inputs)
+            os << vecToString(input->getDims());
+        os << "|" << vecToString(getOpAttrVector());
+        return os.str();
+    }
+
+    double OperatorObj::getMinBytes() const
+    {
+        double bytes = 0;
+        std::unordered_set<TensorObj *> seen;
+        for (auto &input : inputs)
+            if (seen.insert(input.get()).second)
+                bytes += input->getBytes();
+        for (auto &output : outputs)
+            bytes += output->getBytes();
+        return bytes;
+    }
+
     vector<DataType> OperatorObj::inferDataType(const TensorVec &inputs) const
     {
         auto dataType = inputs[0]->getDType();
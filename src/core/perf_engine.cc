@@ -0,0 +1,70 @@
+#include "core/perf_engine.h"
+#include "utils/operator_utils.h"
+#include <cstdlib>
+#include <fstream>
+
+namespace infini
+{
+    // Each line of a tuning file is "<key>\t<kernel name>".
+    static constexpr char tuningFileHeader[] = "# InfiniTensor tuning file v1";
+
+    PerfEngine::PerfEngine()
+    {
+        if (const char *path = std::getenv("INFINI_TUNING_FILE"))
+        {
+            tuningFile = path;
+            load(tuningFile);
+        }
+    }
+
+    string PerfEngine::getKey(const KernelAttrs &kernelAttrs, const Operator &op)
+    {
+        return get_kernel_attrs_str(kernelAttrs) + "|" + op->getOpSignature();
+    }
+
+    optional<string> PerfEngine::getRecord(const string &key) const
+    {
+        auto it = records.find(key);
+        if (it == records.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    void PerfEngine::setRecord(const string &key, const string &kernelName)
+    {
+        records[key] = kernelName;
+    }
+
+    bool PerfEngine::load(const string &path)
+    {
+        std::ifstream file(path);
+        if (!file)
+            return false;
+        string line;
+        IT_ASSERT(std::getline(file, line) && line == tuningFileHeader,
+                  "Invalid tuning file " + path);
+        while (std::getline(file, line))
+        {
+            auto pos = line.rfind('\t');
+            IT_ASSERT(pos != string::npos, "Invalid tuning record: " + line);
+            records[line.substr(0, pos)] = line.substr(pos + 1);
+        }
+        return true;
+    }
+
+    void PerfEngine::save(const string &path) const
+    {
+        std::ofstream file(path);
+        IT_ASSERT(file.good(), "Cannot write tuning file " + path);
+        file << tuningFileHeader << "\n";
+        for (auto &[key, kernelName] : records)
+            file << key << "\t" << kernelName << "\n";
+    }
+
+    void PerfEngine::saveTuningFile() const
+    {
+        if (!tuningFile.empty())
+            save(tuningFile);
+    }
+
+} // namespace infini
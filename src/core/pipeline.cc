@@ -0,0 +1,209 @@
+#include "core/pipeline.h"
+#include "core/runtime.h"
+#include <chrono>
+#include <cstring>
+#include <limits>
+
+namespace infini
+{
+    vector<size_t> PipelineExecutor::partition(const vector<double> &costs,
+                                               int nStages)
+    {
+        size_t n = costs.size();
+        size_t k = std::min<size_t>(std::max(nStages, 1), n);
+        if (n == 0)
+            return {};
+        vector<double> prefix(n + 1, 0);
+        for (size_t i = 0; i < n; ++i)
+            prefix[i + 1] = prefix[i] + costs[i];
+        // best[s][j]: the cost of the most expensive of s ranges covering the
+        // first j costs, cut[s][j]: where the last of them begins
+        constexpr double inf = std::numeric_limits<double>::infinity();
+        vector<vector<double>> best(k + 1, vector<double>(n + 1, inf));
+        vector<vector<size_t>> cut(k + 1, vector<size_t>(n + 1, 0));
+        best[0][0] = 0;
+        for (size_t s = 1; s <= k; ++s)
+            for (size_t j = s; j <= n; ++j)
+                for (size_t i = s - 1; i < j; ++i)
+                {
+                    double cost = std::max(best[s - 1][i], prefix[j] - prefix[i]);
+                    if (cost < best[s][j])
+                    {
+                        best[s][j] = cost;
+                        cut[s][j] = i;
+                    }
+                }
+        vector<size_t> begins(k);
+        for (size_t s = k, j = n; s > 0; --s)
+        {
+            begins[s - 1] = cut[s][j];
+            j = cut[s][j];
+        }
+        return begins;
+    }
+
+    vector<double> PipelineExecutor::profile() const
+    {
+        auto runtime = graph->getRuntime();
+        auto context = graph->acquireContext();
+        ExecutionScope scope(context);
+        // a warm-up run also settles the kernel selection
+        runtime->run(graph);
+        vector<double> costs;
+        for (auto &op : graph->getOperators())
+        {
+            double best = std::numeric_limits<double>::max();
+            for (int i = 0; i < 3; ++i)
+            {
+                auto begin = std::chrono::steady_clock::now();
+                runtime->runOps({op});
+                auto end = std::chrono::steady_clock::now();
+                best = std::min(
+                    best, std::chrono::duration<double>(end - begin).count());
+            }
+            costs.emplace_back(best);
+        }
+        return costs;
+    }
+
+    PipelineExecutor::PipelineExecutor(Graph graph_, TensorVec outputs_,
+                                       PipelineOptions options)
+        : graph(std::move(graph_)), outputs(std::move(outputs_))
+    {
+        const auto &ops = graph->getOperators();
+        IT_ASSERT(!ops.empty(), "Cannot pipeline an empty graph");
+        auto begins = partition(profile(), options.nStages);
+        for (size_t s = 0; s < begins.size(); ++s)
+        {
+            size_t end = s + 1 < begins.size() ? begins[s + 1] : ops.size();
+            stages.emplace_back(ops.begin() + begins[s], ops.begin() + end);
+        }
+
+        auto stageCpus = options.stageCpus;
+        if (stageCpus.empty())
+        {
+            auto cpus = getAllowedCpus();
+            stageCpus.resize(stages.size());
+            if (cpus.size() < stages.size())
+                for (size_t i = 0; i < stages.size(); ++i)
+                    stageCpus[i] = {cpus[i % cpus.size()]};
+            else
+                for (size_t i = 0; i < cpus.size(); ++i)
+                    stageCpus[i * stages.size() / cpus.size()].emplace_back(
+                        cpus[i]);
+        }
+        IT_ASSERT(stageCpus.size() >= stages.size(),
+                  "Not enough core sets for the pipeline stages");
+        // every core set is checked before any thread starts
+        for (size_t i = 0; i < stages.size(); ++i)
+            checkCpus(stageCpus[i]);
+
+        for (size_t i = 0; i < stages.size(); ++i)
+        {
+            queues.emplace_back(
+                std::make_unique<SpscQueue<MicroBatch>>(options.queueDepth));
+            // the stage's thread is member 0 of its team
+            teams.emplace_back(std::make_unique<ParallelTeam>(
+                stageCpus[i].size(), stageCpus[i]));
+        }
+        try
+        {
+            for (size_t i = 0; i < stages.size(); ++i)
+            {
+                threads.emplace_back([this, i] { runStage(i); });
+                pinThread(threads.back(), stageCpus[i]);
+            }
+        }
+        catch (...)
+        {
+            stop();
+            throw;
+        }
+    }
+
+    PipelineExecutor::~PipelineExecutor() { stop(); }
+
+    void PipelineExecutor::stop()
+    {
+        queues.front()->push(MicroBatch{});
+        for (auto &thread : threads)
+            thread.join();
+    }
+
+    std::future<vector<vector<char>>>
+    PipelineExecutor::submit(vector<std::pair<Tensor, vector<char>>> inputs)
+    {
+        MicroBatch batch{graph->acquireContext(), {}, nullptr};
+        auto future = batch.result.get_future();
+        ExecutionScope scope(batch.context);
+        for (auto &[tensor, data] : inputs)
+        {
+            IT_ASSERT(data.size() == tensor->getBytes(),
+                      "Wrong input size for " + tensor->toString());
+            std::memcpy(tensor->getRawDataPtr<void *>(), data.data(),
+                        data.size());
+        }
+        queues.front()->push(std::move(batch));
+        return future;
+    }
+
+    void PipelineExecutor::runStage(size_t stage)
+    {
+        auto runtime = graph->getRuntime();
+        // kernels of the stage run on the stage's cores
+        TeamScope teamScope(teams[stage].get());
+        bool last = stage + 1 == stages.size();
+        size_t idlePolls = 0;
+        while (true)
+        {
+            auto batch = queues[stage]->tryPop();
+            if (!batch)
+            {
+                // back off when the pipeline runs dry
+                if (++idlePolls < 1024)
+                    std::this_thread::yield();
+                else
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                continue;
+            }
+            idlePolls = 0;
+            if (!batch->context)
+            {
+                if (!last)
+                    queues[stage + 1]->push(std::move(*batch));
+                return;
+            }
+            if (!batch->error)
+            {
+                try
+                {
+                    ExecutionScope scope(batch->context);
+                    runtime->runOps(stages[stage]);
+                }
+                catch (...)
+                {
+                    batch->error = std::current_exception();
+                }
+            }
+            if (!last)
+            {
+                queues[stage + 1]->push(std::move(*batch));
+                continue;
+            }
+            if (batch->error)
+            {
+                batch->result.set_exception(batch->error);
+                continue;
+            }
+            ExecutionScope scope(batch->context);
+            vector<vector<char>> results;
+            for (auto &output : outputs)
+            {
+                auto ptr = output->getRawDataPtr<char *>();
+                results.emplace_back(ptr, ptr + output->getBytes());
+            }
+            batch->result.set_value(std::move(results));
+        }
+    }
+
+} // namespace infini
@@ -0,0 +1,300 @@
+#include "core/graph.h"
+#include "core/blob.h"
+#include "core/kernel.h"
+#include "core/perf_engine.h"
+#include "core/serializer.h"
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+namespace infini
+{
+    // A plan file is line based text:
+    //   header
+    //   key <hex>
+    //   arena <bytes>
+    //   tensors <n>, then per tensor: <built index> <offset|-1> <rank> <dims>
+    //   ops <n>, then per op: <type> <n> <inputs> <n> <outputs> <n> <ints>
+    //                         <n> <float bit patterns>
+    //   kernels <n>, then per record: <perf key>\t<kernel name>
+    // Offsets of -1 mark tensors bound outside the arena.
+    static constexpr char planFileHeader[] = "# InfiniTensor plan v1";
+    // Version of the planning rules (op order, in-place and concat
+    // placement, arena layout). Bump it when they change so that plans of
+    // older builds are not applied.
+    static constexpr int plannerVersion = 1;
+
+    // 64-bit FNV-1a, stable across processes and builds.
+    static uint64_t fnv1a(const string &str)
+    {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (unsigned char c : str)
+        {
+            hash ^= c;
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    template <typename T>
+    static void writeVec(std::ostream &os, const vector<T> &values)
+    {
+        os << " " << values.size();
+        for (auto &value : values)
+            os << " " << value;
+    }
+
+    template <typename T>
+    static vector<T> readVec(std::istream &is)
+    {
+        size_t size = 0;
+        is >> size;
+        vector<T> values(size);
+        for (auto &value : values)
+            is >> value;
+        return values;
+    }
+
+    static vector<uint32_t> floatsToBits(const vector<float> &floats)
+    {
+        vector<uint32_t> bits(floats.size());
+        std::memcpy(bits.data(), floats.data(), floats.size() * sizeof(float));
+        return bits;
+    }
+
+    static vector<float> bitsToFloats(const vector<uint32_t> &bits)
+    {
+        vector<float> floats(bits.size());
+        std::memcpy(floats.data(), bits.data(), bits.size() * sizeof(float));
+        return floats;
+    }
+
+    string GraphObj::computePlanKey() const
+    {
+        std::ostringstream os;
+        os << runtime->toString() << "|"
+           << isaLevelToString(runtime->getIsaLevel()) << "\n";
+        // a build with other kernels or planning rules plans differently
+        os << planFileHeader << "|planner " << plannerVersion << "\n";
+        for (auto &[attrs, record] :
+             KernelRegistry::getInstance().getAllKernels())
+            os << get_kernel_attrs_str(attrs) << std::get<1>(*record) << "\n";
+        std::unordered_map<const TensorObj *, size_t> ids;
+        for (auto &tensor : tensors)
+        {
+            ids.emplace(tensor.get(), ids.size());
+            os << tensor->getDType().toString() << vecToString(tensor->getDims())
+               << (tensor->hasData() ? "bound" : "") << "\n";
+        }
+        for (auto &op : ops)
+        {
+            vector<size_t> inputs, outputs;
+            for (auto &input : op->getInputs())
+                inputs.emplace_back(ids.at(input.get()));
+            for (auto &output : op->getOutputs())
+                outputs.emplace_back(ids.at(output.get()));
+            vector<int> ints;
+            vector<float> floats;
+            getOpAttrs(op, ints, floats);
+            os << op->getOpType().toString() << vecToString(inputs)
+               << vecToString(outputs) << vecToString(ints)
+               << vecToString(floatsToBits(floats)) << "\n";
+        }
+        std::ostringstream key;
+        key << std::hex << std::setw(16) << std::setfill('0') << fnv1a(os.str());
+        return key.str();
+    }
+
+    bool GraphObj::compile(const string &planFile)
+    {
+        planKey = computePlanKey();
+        planTensorIds.clear();
+        for (auto &tensor : tensors)
+            planTensorIds.emplace(tensor.get(), planTensorIds.size());
+
+        if (!planFile.empty() && loadPlan(planFile))
+            return true;
+        IT_ASSERT(topo_sort() == true);
+        optimize();
+        shape_infer();
+        dataMalloc();
+        if (!planFile.empty())
+            savePlan(planFile);
+        return false;
+    }
+
+    void GraphObj::savePlan(const string &planFile) const
+    {
+        IT_ASSERT(!planKey.empty(), "savePlan requires a compiled graph");
+        std::ofstream file(planFile);
+        IT_ASSERT(file.good(), "Cannot write plan file " + planFile);
+        file << planFileHeader << "\n";
+        file << "key " << planKey << "\n";
+        file << "arena " << allocator.getPeak() << "\n";
+
+        auto base = static_cast<char *>(allocator.getBasePtr());
+        file << "tensors " << tensors.size() << "\n";
+        for (auto &tensor : tensors)
+        {
+            auto ptr = tensor->getRawDataPtr<char *>();
+            bool inArena = ptr >= base && ptr < base + allocator.getPeak();
+            file << planTensorIds.at(tensor.get()) << " "
+                 << (inArena ? (long long)(ptr - base) : -1LL);
+            writeVec(file, tensor->getDims());
+            file << "\n";
+        }
+
+        std::unordered_map<const TensorObj *, size_t> ids;
+        for (auto &tensor : tensors)
+            ids.emplace(tensor.get(), ids.size());
+        auto &perfEngine = PerfEngine::getInstance();
+        std::map<string, string> kernels;
+        file << "ops " << ops.size() << "\n";
+        for (auto &op : ops)
+        {
+            vector<size_t> inputs, outputs;
+            for (auto &input : op->getInputs())
+                inputs.emplace_back(ids.at(input.get()));
+            for (auto &output : op->getOutputs())
+                outputs.emplace_back(ids.at(output.get()));
+            vector<int> ints;
+            vector<float> floats;
+            getOpAttrs(op, ints, floats);
+            file << op->getOpType().underlying();
+            writeVec(file, inputs);
+            writeVec(file, outputs);
+            writeVec(file, ints);
+            writeVec(file, floatsToBits(floats));
+            file << "\n";
+
+            auto key = PerfEngine::getKey(
+                KernelAttrs{runtime->getDevice(), op->getOpType().underlying(),
+                            runtime->getIsaLevel()},
+                op);
+            if (auto kernelName = perfEngine.getRecord(key))
+                kernels[key] = *kernelName;
+        }
+        file << "kernels " << kernels.size() << "\n";
+        for (auto &[key, kernelName] : kernels)
+            file << key << "\t" << kernelName << "\n";
+        IT_ASSERT(file.good(), "Failed to write plan file " + planFile);
+    }
+
+    bool GraphObj::loadPlan(const string &planFile)
+    {
+        std::ifstream file(planFile);
+        if (!file)
+            return false;
+        string line, word, key;
+        if (!std::getline(file, line) || line != planFileHeader)
+            return false;
+        file >> word >> key;
+        if (word != "key" || key != planKey)
+            return false;
+
+        // Parse everything before touching the graph.
+        size_t arena = 0, nTensors = 0, nOps = 0, nKernels = 0;
+        file >> word >> arena >> word >> nTensors;
+        IT_ASSERT(file.good(), "Invalid plan file " + planFile);
+        TensorVec builtTensors(planTensorIds.size());
+        for (auto &tensor : tensors)
+            builtTensors[planTensorIds.at(tensor.get())] = tensor;
+        TensorVec planTensors;
+        vector<long long> offsets;
+        vector<Shape> shapes;
+        for (size_t i = 0; i < nTensors; ++i)
+        {
+            size_t id = 0;
+            long long offset = 0;
+            file >> id >> offset;
+            IT_ASSERT(id < builtTensors.size(), "Invalid plan file " + planFile);
+            planTensors.emplace_back(builtTensors[id]);
+            offsets.emplace_back(offset);
+            shapes.emplace_back(readVec<int>(file));
+            if (offset < 0)
+                continue;
+            // a placed tensor lies in the arena
+            size_t bytes = builtTensors[id]->getDType().getSize();
+            for (int dim : shapes.back())
+            {
+                IT_ASSERT(dim >= 0 && (dim == 0 || bytes <= arena / dim),
+                          "Invalid plan file " + planFile);
+                bytes *= dim;
+            }
+            IT_ASSERT(size_t(offset) <= arena && bytes <= arena - offset,
+                      "Invalid plan file " + planFile + ": tensor " +
+                          std::to_string(i) + " outside the arena");
+        }
+        struct PlanOp
+        {
+            OpType::underlying_t type;
+            vector<size_t> inputs, outputs;
+            vector<int> ints;
+            vector<float> floats;
+        };
+        vector<PlanOp> planOps;
+        file >> word >> nOps;
+        for (size_t i = 0; i < nOps; ++i)
+        {
+            PlanOp op;
+            file >> op.type;
+            op.inputs = readVec<size_t>(file);
+            op.outputs = readVec<size_t>(file);
+            op.ints = readVec<int>(file);
+            op.floats = bitsToFloats(readVec<uint32_t>(file));
+            planOps.emplace_back(std::move(op));
+        }
+        file >> word >> nKernels;
+        std::getline(file, line);
+        vector<pair<string, string>> kernels;
+        for (size_t i = 0; i < nKernels && std::getline(file, line); ++i)
+        {
+            auto pos = line.rfind('\t');
+            IT_ASSERT(pos != string::npos, "Invalid plan file " + planFile);
+            kernels.emplace_back(line.substr(0, pos), line.substr(pos + 1));
+        }
+        IT_ASSERT(!file.bad() && kernels.size() == nKernels,
+                  "Invalid plan file " + planFile);
+
+        // Rebuild the operators over the surviving tensors in plan order.
+        for (auto &tensor : tensors)
+        {
+            tensor->targets.clear();
+            tensor->source.reset();
+        }
+        ops.clear();
+        tensors = planTensors;
+        for (size_t i = 0; i < tensors.size(); ++i)
+            tensors[i]->setShape(shapes[i]);
+        for (auto &op : planOps)
+        {
+            TensorVec inputs, outputs;
+            for (auto id : op.inputs)
+                inputs.emplace_back(tensors.at(id));
+            for (auto id : op.outputs)
+                outputs.emplace_back(tensors.at(id));
+            addOpFromAttrs(this, OpType(op.type), inputs, outputs, op.ints,
+                           op.floats);
+        }
+        sorted = true;
+
+        auto &perfEngine = PerfEngine::getInstance();
+        for (auto &[key, kernelName] : kernels)
+            perfEngine.setRecord(key, kernelName);
+
+        allocator.setPeak(arena);
+        // as in dataMalloc, only graph inputs may be read before written
+        auto base = static_cast<char *>(allocator.getPtr(false));
+        for (size_t i = 0; i < tensors.size(); ++i)
+        {
+            if (offsets[i] < 0)
+                continue;
+            tensors[i]->setDataBlob(make_ref<BlobObj>(
+                runtime, base + offsets[i], &allocator, offsets[i]));
+            if (!tensors[i]->getSource())
+                std::memset(base + offsets[i], 0, tensors[i]->getBytes());
+        }
+        return true;
+    }
+
+} // namespace infini
@@ -0,0 +1,432 @@
+#include "core/profiler.h"
+#include "core/runtime.h"
+#include <cstring>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <limits>
+#include <linux/perf_event.h>
+#include <sstream>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace infini
+{
+    static const std::pair<uint64_t, const char *> counterEvents[] = {
+        {PERF_COUNT_HW_CPU_CYCLES, "cycles"},
+        {PERF_COUNT_HW_INSTRUCTIONS, "instructions"},
+        {PERF_COUNT_HW_CACHE_MISSES, "llc_misses"},
+        {PERF_COUNT_HW_BRANCH_MISSES, "branch_misses"},
+    };
+
+    /**
+     * @brief The counters of one thread, opened as a group so that one read
+     * returns all of them.
+     */
+    class CounterGroup
+    {
+        vector<int> fds;
+        vector<int> counters;
+
+    public:
+        // tid 0 is the calling thread
+        explicit CounterGroup(int tid = 0);
+        ~CounterGroup();
+        unsigned getAvailable() const
+        {
+            unsigned mask = 0;
+            for (auto counter : counters)
+                mask |= 1u << counter;
+            return mask;
+        }
+        void addTo(Profiler::Counters &sum) const;
+    };
+
+    CounterGroup::CounterGroup(int tid)
+    {
+        for (int i = 0; i < Profiler::NCounters; ++i)
+        {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = counterEvents[i].first;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            int leader = fds.empty() ? -1 : fds.front();
+            int fd = syscall(SYS_perf_event_open, &attr, tid, -1, leader, 0);
+            if (fd < 0)
+                continue;
+            fds.emplace_back(fd);
+            counters.emplace_back(i);
+        }
+    }
+
+    CounterGroup::~CounterGroup()
+    {
+        for (int fd : fds)
+            close(fd);
+    }
+
+    void CounterGroup::addTo(Profiler::Counters &sum) const
+    {
+        if (fds.empty())
+            return;
+        uint64_t values[1 + Profiler::NCounters];
+        if (read(fds.front(), values, sizeof(values)) <= 0)
+            return;
+        for (size_t i = 0; i < values[0] && i < counters.size(); ++i)
+            sum[counters[i]] += values[1 + i];
+    }
+
+    // The counter group of the calling thread, opened on first use.
+    static const CounterGroup &getThreadCounters()
+    {
+        static thread_local CounterGroup group;
+        return group;
+    }
+
+    Profiler::Profiler(bool useCounters)
+    {
+        if (useCounters)
+            available = getThreadCounters().getAvailable();
+    }
+
+    Profiler::~Profiler() = default;
+
+    bool Profiler::hasCounter(Counter counter) const
+    {
+        return available & (1u << counter);
+    }
+
+    const CounterGroup &Profiler::getWorkerCounters(int tid) const
+    {
+        auto &group = workerGroups[tid];
+        if (!group)
+            group = std::make_unique<CounterGroup>(tid);
+        return *group;
+    }
+
+    void Profiler::attach(const RuntimeObj *runtime) const
+    {
+        if (!available)
+            return;
+        auto &tids = runtime->getTeam()->getWorkerTids();
+        std::lock_guard<std::mutex> lock(groupsMutex);
+        // close the groups of other teams, e.g. the exited workers of a
+        // replaced team, whose ids may be reused by new threads
+        for (auto it = workerGroups.begin(); it != workerGroups.end();)
+            if (std::find(tids.begin(), tids.end(), it->first) == tids.end())
+                it = workerGroups.erase(it);
+            else
+                ++it;
+        for (int tid : tids)
+            getWorkerCounters(tid);
+    }
+
+    Profiler::Counters Profiler::readCounters(const ParallelTeam *team) const
+    {
+        Counters sum{};
+        getThreadCounters().addTo(sum);
+        std::lock_guard<std::mutex> lock(groupsMutex);
+        for (int tid : team->getWorkerTids())
+            getWorkerCounters(tid).addTo(sum);
+        return sum;
+    }
+
+    Profiler::Mark Profiler::begin(const RuntimeObj *runtime) const
+    {
+        Mark mark;
+        if (available)
+        {
+            mark.team = runtime->getTeam();
+            mark.counters = readCounters(mark.team);
+        }
+        mark.time = std::chrono::steady_clock::now();
+        return mark;
+    }
+
+    void Profiler::end(const Mark &mark, const Operator &op,
+                       const string &kernel)
+    {
+        auto time = std::chrono::steady_clock::now();
+        Counters counters{};
+        if (available)
+        {
+            counters = readCounters(mark.team);
+            for (int i = 0; i < NCounters; ++i)
+                counters[i] -= mark.counters[i];
+        }
+        string opType = op->getOpType().toString();
+        std::lock_guard<std::mutex> lock(mutex);
+        auto &entry = entries[{opType, kernel}];
+        entry.opType = opType;
+        entry.kernel = kernel;
+        ++entry.calls;
+        entry.ms +=
+            std::chrono::duration<double, std::milli>(time - mark.time).count();
+        entry.flops += op->getFlops();
+        entry.bytes += op->getMinBytes();
+        for (int i = 0; i < NCounters; ++i)
+            entry.counters[i] += counters[i];
+    }
+
+    vector<Profiler::Entry> Profiler::getEntries() const
+    {
+        vector<Entry> ret;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto &[key, entry] : entries)
+                ret.emplace_back(entry);
+        }
+        std::stable_sort(ret.begin(), ret.end(),
+                         [](const Entry &a, const Entry &b)
+                         { return a.ms > b.ms; });
+        return ret;
+    }
+
+    void Profiler::clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+    }
+
+    string Profiler::report() const
+    {
+        auto all = getEntries();
+        double total = 0;
+        for (auto &entry : all)
+            total += entry.ms;
+        std::ostringstream os;
+        os << std::left << std::setw(12) << "op" << std::setw(22) << "kernel"
+           << std::right << std::setw(8) << "calls" << std::setw(12)
+           << "total ms" << std::setw(8) << "%" << std::setw(12) << "avg us"
+           << std::setw(10) << "GB/s";
+        bool hasIpc = hasCounter(Cycles) && hasCounter(Instructions);
+        if (hasIpc)
+            os << std::setw(8) << "IPC";
+        if (hasCounter(LlcMisses))
+            os << std::setw(14) << "LLC miss/KB";
+        if (hasCounter(BranchMisses) && hasCounter(Instructions))
+            os << std::setw(14) << "br miss/Kinst";
+        os << "\n" << std::fixed;
+        for (auto &entry : all)
+        {
+            os << std::left << std::setw(12) << entry.opType << std::setw(22)
+               << entry.kernel << std::right << std::setw(8) << entry.calls
+               << std::setprecision(3) << std::setw(12) << entry.ms
+               << std::setprecision(1) << std::setw(8)
+               << (total ? 100 * entry.ms / total : 0) << std::setw(12)
+               << 1e3 * entry.ms / entry.calls << std::setprecision(2)
+               << std::setw(10) << entry.bytes / entry.ms * 1e-6;
+            auto &c = entry.counters;
+            auto ratio = [](double a, double b) { return b ? a / b : 0; };
+            if (hasIpc)
+                os << std::setw(8) << ratio(c[Instructions], c[Cycles]);
+            if (hasCounter(LlcMisses))
+                os << std::setw(14) << ratio(c[LlcMisses], entry.bytes / 1024);
+            if (hasCounter(BranchMisses) && hasCounter(Instructions))
+                os << std::setw(14)
+                   << ratio(c[BranchMisses], c[Instructions] / 1000.);
+            os << "\n";
+        }
+        os << "total " << std::setprecision(3) << total << " ms";
+        if (!hasCounters())
+            os << ", hardware counters unavailable";
+        os << "\n";
+        return os.str();
+    }
+
+    string Profiler::toJson() const
+    {
+        std::ostringstream os;
+        os << "[";
+        auto all = getEntries();
+        for (size_t i = 0; i < all.size(); ++i)
+        {
+            auto &entry = all[i];
+            os << (i ? ",\n " : "\n ") << "{\"op\": \"" << entry.opType
+               << "\", \"kernel\": \"" << entry.kernel
+               << "\", \"calls\": " << entry.calls << ", \"ms\": " << entry.ms
+               << ", \"flops\": " << entry.flops
+               << ", \"bytes\": " << entry.bytes;
+            for (int j = 0; j < NCounters; ++j)
+                if (hasCounter(Counter(j)))
+                    os << ", \"" << counterEvents[j].second
+                       << "\": " << entry.counters[j];
+            os << "}";
+        }
+        os << "\n]\n";
+        return os.str();
+    }
+
+    // iterations of the FMA probe on each thread
+    constexpr size_t fmaIterations = 1 << 22;
+
+    // FMA throughput probes: independent accumulators hide the FMA latency.
+    // Each returns a value depending on all of them so that no work is
+    // dropped, and adds the operations done to flops.
+    static float fmaScalar(double &flops)
+    {
+        float acc[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+        const float a = 0.999999f, b = 1e-7f;
+        for (size_t i = 0; i < fmaIterations; ++i)
+            for (auto &x : acc)
+                x = x * a + b;
+        flops = 2. * 8 * fmaIterations;
+        float sum = 0;
+        for (auto x : acc)
+            sum += x;
+        return sum;
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    __attribute__((target("avx2,fma"))) static float fmaAvx2(double &flops)
+    {
+        __m256 acc[10];
+        for (int j = 0; j < 10; ++j)
+            acc[j] = _mm256_set1_ps(j);
+        const __m256 a = _mm256_set1_ps(0.999999f), b = _mm256_set1_ps(1e-7f);
+        for (size_t i = 0; i < fmaIterations; ++i)
+            for (auto &x : acc)
+                x = _mm256_fmadd_ps(x, a, b);
+        flops = 2. * 10 * 8 * fmaIterations;
+        float sum = 0;
+        for (auto &x : acc)
+            sum += _mm256_cvtss_f32(x);
+        return sum;
+    }
+
+    __attribute__((target("avx512f"))) static float fmaAvx512(double &flops)
+    {
+        __m512 acc[12];
+        for (int j = 0; j < 12; ++j)
+            acc[j] = _mm512_set1_ps(j);
+        const __m512 a = _mm512_set1_ps(0.999999f), b = _mm512_set1_ps(1e-7f);
+        for (size_t i = 0; i < fmaIterations; ++i)
+            for (auto &x : acc)
+                x = _mm512_fmadd_ps(x, a, b);
+        flops = 2. * 12 * 16 * fmaIterations;
+        float sum = 0;
+        for (auto &x : acc)
+            sum += _mm512_cvtss_f32(x);
+        return sum;
+    }
+#endif
+
+    static MachinePeak measurePeak(const RuntimeObj *runtime)
+    {
+        using Clock = std::chrono::steady_clock;
+        auto seconds = [](Clock::time_point begin) {
+            return std::chrono::duration<double>(Clock::now() - begin).count();
+        };
+        MachinePeak peak;
+        size_t nThreads = runtime->getThreadCount();
+
+        // triad a = b + s * c over arrays well beyond the last level cache,
+        // first touched by the members which stream them
+        constexpr size_t n = 8 << 20;
+        std::unique_ptr<float[]> a(new float[n]), b(new float[n]),
+            c(new float[n]);
+        auto triad = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                a[i] = b[i] + 3.f * c[i];
+        };
+        runtime->parallelFor(0, n, 1 << 16, [&](size_t begin, size_t end) {
+            std::fill(a.get() + begin, a.get() + end, 0.f);
+            std::fill(b.get() + begin, b.get() + end, 1.f);
+            std::fill(c.get() + begin, c.get() + end, 2.f);
+        });
+        double best = std::numeric_limits<double>::max();
+        for (int rep = 0; rep < 5; ++rep)
+        {
+            auto begin = Clock::now();
+            runtime->parallelFor(0, n, 1 << 16, triad);
+            best = std::min(best, seconds(begin));
+        }
+        peak.gbps = 3. * n * sizeof(float) / best * 1e-9;
+
+        // one FMA probe per member
+        auto isa = runtime->getIsaLevel();
+        vector<double> flops(nThreads);
+        vector<float> sums(nThreads);
+        auto begin = Clock::now();
+        runtime->parallelFor(0, nThreads, 1, [&](size_t first, size_t last) {
+            for (size_t t = first; t < last; ++t)
+            {
+#if defined(__x86_64__) || defined(__i386__)
+                if (isa >= IsaLevel::AVX512)
+                    sums[t] = fmaAvx512(flops[t]);
+                else if (isa >= IsaLevel::AVX2)
+                    sums[t] = fmaAvx2(flops[t]);
+                else
+#endif
+                    sums[t] = fmaScalar(flops[t]);
+            }
+        });
+        double elapsed = seconds(begin), total = 0;
+        for (auto done : flops)
+            total += done;
+        peak.gflops = total / elapsed * 1e-9;
+        // keep the probes from being optimized away
+        static std::atomic<float> sink;
+        for (auto sum : sums)
+            sink.store(sum, std::memory_order_relaxed);
+        return peak;
+    }
+
+    MachinePeak probeMachinePeak(const RuntimeObj *runtime)
+    {
+        static std::mutex mutex;
+        static std::map<std::pair<size_t, IsaLevel>, MachinePeak> peaks;
+        std::lock_guard<std::mutex> lock(mutex);
+        auto key = std::make_pair(runtime->getThreadCount(),
+                                  runtime->getIsaLevel());
+        auto it = peaks.find(key);
+        if (it == peaks.end())
+            it = peaks.emplace(key, measurePeak(runtime)).first;
+        return it->second;
+    }
+
+    string Profiler::roofline(const MachinePeak &peak) const
+    {
+        std::ostringstream os;
+        os << std::fixed << std::setprecision(2) << "peak " << peak.gflops
+           << " GFLOP/s, " << peak.gbps << " GB/s, ridge "
+           << peak.gflops / peak.gbps << " FLOP/B\n";
+        os << std::left << std::setw(12) << "op" << std::setw(22) << "kernel"
+           << std::right << std::setw(10) << "FLOP/B" << std::setw(10)
+           << "GFLOP/s" << std::setw(10) << "GB/s" << std::setw(10) << "roof"
+           << std::setw(10) << "% roof" << std::setw(10) << "bound"
+           << std::setw(12) << "ms lost" << "\n";
+        for (auto &entry : getEntries())
+        {
+            double seconds = entry.ms * 1e-3;
+            double intensity = entry.bytes ? entry.flops / entry.bytes : 0;
+            double gflops = entry.flops / seconds * 1e-9,
+                   gbps = entry.bytes / seconds * 1e-9;
+            bool memoryBound = intensity * peak.gbps < peak.gflops;
+            // ops without arithmetic are measured against the bandwidth
+            double roof = peak.gbps, achieved = gbps;
+            if (entry.flops)
+            {
+                roof = memoryBound ? intensity * peak.gbps : peak.gflops;
+                achieved = gflops;
+            }
+            double fraction = roof ? achieved / roof : 0;
+            os << std::left << std::setw(12) << entry.opType << std::setw(22)
+               << entry.kernel << std::right << std::setw(10) << intensity
+               << std::setw(10) << gflops << std::setw(10) << gbps
+               << std::setw(10) << roof << std::setw(10) << 100 * fraction
+               << std::setw(10) << (memoryBound ? "memory" : "compute")
+               << std::setw(12)
+               << entry.ms * (1 - std::min(fraction, 1.)) << "\n";
+        }
+        return os.str();
+    }
+
+} // namespace infini
@@ -1,36 +1,416 @@
 #include "core/runtime.h"
 #include "core/blob.h"
+#include "core/execution.h"
 #include "core/kernel.h"
 #include "core/graph.h"
-#include "core/kernel.h"
+#include "core/perf_engine.h"
+#include "core/profiler.h"
 #include <chrono>
+#include <cctype>
+#include <cstdlib>
+#include <dirent.h>
 #include <cstring>
+#include <limits>
 #include <memory>
+#include <set>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 namespace infini
 {
-    void NativeCpuRuntimeObj::run(const Graph &graph) const
+    // Inputs of op whose buffers overlap an output, e.g. the input of an op
+    // planned in place, and a copy of their bytes. Timing a kernel runs it
+    // several times, each run must see the original inputs.
+    using SavedInputs = vector<std::pair<Tensor, vector<char>>>;
+
+    static SavedInputs saveAliasedInputs(const Operator &op)
+    {
+        SavedInputs saved;
+        for (auto &input : op->getInputs())
+        {
+            auto begin = input->getRawDataPtr<char *>();
+            auto end = begin + input->getBytes();
+            for (auto &output : op->getOutputs())
+            {
+                auto outBegin = output->getRawDataPtr<char *>();
+                if (outBegin < end && begin < outBegin + output->getBytes())
+                {
+                    saved.emplace_back(input, vector<char>(begin, end));
+                    break;
+                }
+            }
+        }
+        return saved;
+    }
+
+    static void restoreInputs(const SavedInputs &saved)
+    {
+        for (auto &[input, data] : saved)
+            std::memcpy(input->getRawDataPtr<void *>(), data.data(),
+                        data.size());
+    }
+
+    // Run a kernel once to warm up and then return the best of a few runs in
+    // milliseconds. Aliased inputs are restored before every run, outside of
+    // the timed region.
+    static double timeKernel(const Kernel *kernel, const Operator &op,
+                             const RuntimeObj *context,
+                             const SavedInputs &saved)
+    {
+        constexpr int repeat = 3;
+        restoreInputs(saved);
+        kernel->compute(op, context);
+        double best = std::numeric_limits<double>::max();
+        for (int i = 0; i < repeat; ++i)
+        {
+            restoreInputs(saved);
+            auto begin = std::chrono::high_resolution_clock::now();
+            kernel->compute(op, context);
+            auto end = std::chrono::high_resolution_clock::now();
+            best = std::min(
+                best,
+                std::chrono::duration<double, std::milli>(end - begin).count());
+        }
+        return best;
+    }
+
+    const KernelRegistry::KernelRecord &
+    NativeCpuRuntimeObj::selectKernel(const Operator &op, bool tune,
+                                      bool &tuned) const
     {
         const auto &kernelRegistry = KernelRegistry::getInstance();
+        auto kernelAttrs = KernelAttrs{device, op->getOpType().underlying(), isa};
+        auto candidates = kernelRegistry.getKernelCandidates(kernelAttrs, op);
+        IT_ASSERT(!candidates.empty(), "No applicable kernel for key {" +
+                                           get_kernel_attrs_str(kernelAttrs) +
+                                           "}");
+        if (candidates.size() == 1)
+            return *candidates.front();
+
+        auto &perfEngine = PerfEngine::getInstance();
+        auto key = PerfEngine::getKey(kernelAttrs, op);
+        if (auto name = perfEngine.getRecord(key))
+        {
+            for (auto candidate : candidates)
+                if (std::get<1>(*candidate) == *name)
+                    return *candidate;
+            // The recorded kernel is not in this build, tune again.
+        }
+        if (!tune)
+            return *candidates.front();
 
-        for (auto &op : graph->getOperators())
+        const KernelRegistry::KernelRecord *best = nullptr;
+        double bestTime = std::numeric_limits<double>::max();
+        auto saved = saveAliasedInputs(op);
+        for (auto candidate : candidates)
         {
-            auto kernelAttrs = KernelAttrs{device, op->getOpType().underlying()};
-            Kernel *kernel = kernelRegistry.getKernel(kernelAttrs);
+            double time = timeKernel(std::get<0>(*candidate), op, this, saved);
+            if (time < bestTime)
+            {
+                best = candidate;
+                bestTime = time;
+            }
+        }
+        // the caller runs the chosen kernel on the original inputs
+        restoreInputs(saved);
+        perfEngine.setRecord(key, std::get<1>(*best));
+        tuned = true;
+        return *best;
+    }
+
+    void NativeCpuRuntimeObj::run(const Graph &graph, bool tune) const
+    {
+        runOps(graph->getOperators(), tune);
+    }
+
+    void NativeCpuRuntimeObj::runOps(const OpVec &ops, bool tune) const
+    {
+        bool tuned = false;
+        for (auto &op : ops)
+        {
+            auto &[kernel, name, id] = selectKernel(op, tune, tuned);
+            if (!profiler)
+            {
+                kernel->compute(op, this);
+                continue;
+            }
+            auto mark = profiler->begin(this);
             kernel->compute(op, this);
+            profiler->end(mark, op, name);
+        }
+        if (tuned)
+            PerfEngine::getInstance().saveTuningFile();
+    }
+
+    std::future<vector<vector<char>>>
+    RuntimeObj::runAsync(const Graph &graph,
+                         vector<std::pair<Tensor, vector<char>>> inputs,
+                         TensorVec outputs) const
+    {
+        for (auto &[tensor, data] : inputs)
+            IT_ASSERT(data.size() == tensor->getBytes(),
+                      "Wrong input size for " + tensor->toString());
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            if (!pool)
+                pool = std::make_unique<ThreadPool>(poolThreads, poolMaxQueued);
+        }
+        auto promise = std::make_shared<std::promise<vector<vector<char>>>>();
+        auto future = promise->get_future();
+        // the task keeps the runtime alive through the graph
+        IT_ASSERT(graph->getRuntime().get() == this,
+                  "runAsync needs a graph of this runtime");
+        pool->submit([graph, inputs = std::move(inputs),
+                      outputs = std::move(outputs), promise]() {
+            try
+            {
+                auto context = graph->acquireContext();
+                ExecutionScope scope(context);
+                for (auto &[tensor, data] : inputs)
+                    std::memcpy(tensor->getRawDataPtr<void *>(), data.data(),
+                                data.size());
+                graph->getRuntime()->run(graph);
+                vector<vector<char>> results;
+                for (auto &output : outputs)
+                {
+                    auto ptr = output->getRawDataPtr<char *>();
+                    results.emplace_back(ptr, ptr + output->getBytes());
+                }
+                promise->set_value(std::move(results));
+            }
+            catch (...)
+            {
+                promise->set_exception(std::current_exception());
+            }
+        });
+        return future;
+    }
+
+    RuntimeObj::~RuntimeObj()
+    {
+        // The last Ref may be dropped by a task of the pool, when the caller
+        // released its own before the request finished. A pool cannot join
+        // its own worker, so it is torn down on a thread of its own, which
+        // waits for that worker to return from the task.
+        if (pool && pool->isWorker())
+            std::thread([pool = std::move(pool)] {}).detach();
+    }
+
+    void RuntimeObj::setAsyncPool(size_t nThreads, size_t maxQueued)
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        IT_ASSERT(!pool, "setAsyncPool must be called before runAsync");
+        poolThreads = nThreads;
+        poolMaxQueued = maxQueued;
+    }
+
+    void RuntimeObj::setParallelism(size_t nThreads, vector<int> cpus)
+    {
+        team = std::make_unique<ParallelTeam>(nThreads, std::move(cpus));
+        if (profiler)
+            profiler->attach(this);
+    }
+
+    void RuntimeObj::setProfiler(Ref<Profiler> profiler_)
+    {
+        profiler = std::move(profiler_);
+        if (profiler)
+            profiler->attach(this);
+    }
+
+    size_t RuntimeObj::getDefaultThreadCount()
+    {
+        if (auto env = std::getenv("INFINI_NUM_THREADS"))
+        {
+            auto n = std::atoi(env);
+            IT_ASSERT(n > 0, string("Invalid INFINI_NUM_THREADS ") + env);
+            return n;
         }
+        return std::max<size_t>(getAllowedCpus().size(), 1);
     }
 
     string NativeCpuRuntimeObj::toString() const { return "CPU Runtime"; }
 
+    // The NUMA node of a core, or -1 if unknown.
+    static int getCpuNode(int cpu)
+    {
+        string dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+        DIR *entries = opendir(dir.c_str());
+        if (!entries)
+            return -1;
+        int node = -1;
+        while (auto entry = readdir(entries))
+            if (std::strncmp(entry->d_name, "node", 4) == 0 &&
+                std::isdigit(entry->d_name[4]))
+                node = std::atoi(entry->d_name + 4);
+        closedir(entries);
+        return node;
+    }
+
+    // Buffers from mapBytes on are mapped, in multiples of hugePageBytes.
+    static constexpr size_t pageBytes = 4096, hugePageBytes = 2 << 20,
+                            mapBytes = 1 << 20;
+
+    static size_t getMappedBytes(size_t size)
+    {
+        return (size + hugePageBytes - 1) / hugePageBytes * hugePageBytes;
+    }
+
+    void *NativeCpuRuntimeObj::allocMapped(size_t size)
+    {
+        size_t bytes = getMappedBytes(size);
+        // Explicit huge pages need a reserved pool, fall back to normal pages
+        // with transparent huge pages requested.
+        void *ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr == MAP_FAILED)
+        {
+            ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr == MAP_FAILED)
+                return nullptr;
+            madvise(ptr, bytes, MADV_HUGEPAGE);
+        }
+
+        // A team pinned to the cores of one node gets its memory there.
+        // Otherwise the pages are placed by first touch below.
+        std::set<int> nodes;
+        for (int cpu : getTeamCpus())
+            nodes.insert(getCpuNode(cpu));
+        if (nodes.size() == 1 && *nodes.begin() >= 0)
+        {
+            int node = *nodes.begin();
+            vector<unsigned long> mask(node / (8 * sizeof(long)) + 1, 0);
+            mask[node / (8 * sizeof(long))] = 1ul << (node % (8 * sizeof(long)));
+            constexpr int mpolPreferred = 1;
+            // best effort, e.g. containers may forbid it
+            syscall(SYS_mbind, ptr, bytes, mpolPreferred, mask.data(),
+                    mask.size() * 8 * sizeof(long), 0);
+        }
+
+        // Fault the pages in on the thread team rather than on the first run.
+        // Anonymous pages are zero, writing zero keeps them so.
+        parallelFor(0, bytes / pageBytes, 64, [&](size_t begin, size_t end)
+                    {
+            for (size_t page = begin; page < end; ++page)
+                static_cast<volatile char *>(ptr)[page * pageBytes] = 0; });
+
+        std::lock_guard<std::mutex> lock(mappingMutex);
+        mappings.emplace(ptr, bytes);
+        return ptr;
+    }
+
+    void *NativeCpuRuntimeObj::allocImpl(size_t size, bool zero)
+    {
+        // Arenas and other large buffers are mapped, their pages come zeroed
+        // from the kernel. Released ones are cached for reuse; only callers
+        // asking for zeroed memory pay for clearing a cached buffer.
+        if (size >= mapBytes)
+        {
+            if (void *ptr = takeCached(getMappedBytes(size)))
+            {
+                if (zero)
+                    parallelFor(0, size, 1 << 20, [&](size_t begin, size_t end)
+                                { std::memset(static_cast<char *>(ptr) + begin,
+                                              0, end - begin); });
+                return ptr;
+            }
+            if (void *ptr = allocMapped(size))
+                return ptr;
+        }
+        size = (size + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+        if (zero)
+            return calloc(size / sizeof(uint64_t), sizeof(uint64_t));
+        return malloc(std::max<size_t>(size, 1));
+    }
+
+    size_t NativeCpuRuntimeObj::getDefaultCacheLimit()
+    {
+        if (auto env = std::getenv("INFINI_ALLOC_CACHE_BYTES"))
+            return std::strtoull(env, nullptr, 10);
+        return size_t(1) << 30;
+    }
+
+    void *NativeCpuRuntimeObj::takeCached(size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mappingMutex);
+        // a larger buffer is only taken when it wastes at most a quarter
+        auto it = cache.lower_bound(bytes);
+        if (it == cache.end() || it->first > bytes + bytes / 4)
+        {
+            ++cacheMisses;
+            return nullptr;
+        }
+        void *ptr = it->second;
+        mappings.emplace(ptr, it->first);
+        cachedBytes -= it->first;
+        cache.erase(it);
+        ++cacheHits;
+        return ptr;
+    }
+
+    void NativeCpuRuntimeObj::evictCache(size_t limit)
+    {
+        // the largest buffers go first
+        while (cachedBytes > limit)
+        {
+            auto it = std::prev(cache.end());
+            munmap(it->second, it->first);
+            cachedBytes -= it->first;
+            cache.erase(it);
+        }
+    }
+
     void NativeCpuRuntimeObj::dealloc(void *ptr)
     {
+        {
+            std::lock_guard<std::mutex> lock(mappingMutex);
+            auto it = mappings.find(ptr);
+            if (it != mappings.end())
+            {
+                size_t bytes = it->second;
+                mappings.erase(it);
+                if (bytes > cacheLimit)
+                    munmap(ptr, bytes);
+                else
+                {
+                    evictCache(cacheLimit - bytes);
+                    cache.emplace(bytes, ptr);
+                    cachedBytes += bytes;
+                }
+                return;
+            }
+        }
         return free(ptr);
     }
 
+    void NativeCpuRuntimeObj::setCacheLimit(size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mappingMutex);
+        cacheLimit = bytes;
+        evictCache(cacheLimit);
+    }
+
+    NativeCpuRuntimeObj::CacheStats NativeCpuRuntimeObj::getCacheStats()
+    {
+        std::lock_guard<std::mutex> lock(mappingMutex);
+        return {cachedBytes, cache.size(), cacheHits, cacheMisses};
+    }
+
+    NativeCpuRuntimeObj::~NativeCpuRuntimeObj()
+    {
+        std::lock_guard<std::mutex> lock(mappingMutex);
+        evictCache(0);
+    }
+
     void *NativeCpuRuntimeObj::alloc(size_t size)
     {
-        return calloc((size + sizeof(uint64_t) - 1) / sizeof(uint64_t),
-                      sizeof(uint64_t));
+        return allocImpl(size, true);
+    }
+
+    void *NativeCpuRuntimeObj::allocUninitialized(size_t size)
+    {
+        return allocImpl(size, false);
     }
 
 } // namespace infini
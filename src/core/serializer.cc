@@ -0,0 +1,442 @@
+#include "core/serializer.h"
+#include "core/blob.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/normalization.h"
+#include "operators/reduce.h"
+#include "operators/softmax.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace infini
+{
+    static constexpr char graphFileMagic[8] = {'I', 'T', 'G', 'R',
+                                               'A', 'P', 'H', '\0'};
+    static constexpr size_t graphFileHeaderBytes = 8 + 4 + 4 + 8 + 8;
+
+    static size_t alignUp(size_t size)
+    {
+        return (size + graphFileAlignment - 1) / graphFileAlignment *
+               graphFileAlignment;
+    }
+
+    namespace
+    {
+        class Writer
+        {
+            string buffer;
+
+        public:
+            template <typename T>
+            void write(const T &value)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+            }
+            template <typename T>
+            void writeVec(const vector<T> &values)
+            {
+                write<uint32_t>(values.size());
+                for (auto &value : values)
+                    write(value);
+            }
+            const string &str() const { return buffer; }
+        };
+
+        class Reader
+        {
+            const char *begin, *ptr, *end;
+            // the file offset of begin
+            size_t origin;
+
+        public:
+            Reader(const char *begin, size_t size, size_t origin = 0)
+                : begin(begin), ptr(begin), end(begin + size), origin(origin) {}
+            template <typename T>
+            T read()
+            {
+                check(sizeof(T) <= remaining(), "Truncated graph file");
+                T value;
+                std::memcpy(&value, ptr, sizeof(T));
+                ptr += sizeof(T);
+                return value;
+            }
+            template <typename T>
+            vector<T> readVec()
+            {
+                auto size = read<uint32_t>();
+                // the length is checked before it is trusted for allocation
+                check(size <= remaining() / sizeof(T), "Truncated graph file");
+                vector<T> values(size);
+                for (auto &value : values)
+                    value = read<T>();
+                return values;
+            }
+            size_t remaining() const { return end - ptr; }
+            size_t offset() const { return origin + (ptr - begin); }
+            // fail with the file offset of the next unread byte
+            void check(bool condition, const string &message) const
+            {
+                IT_ASSERT(condition,
+                          message + " at offset " + std::to_string(offset()));
+            }
+        };
+
+        // DataTypes whose elements are plain bytes of a known size
+        bool isStorableDType(int32_t index)
+        {
+            constexpr int32_t nTypes = std::size(DataType::sizePerElement);
+            return index >= 0 && index < nTypes &&
+                   DataType::sizePerElement[index] > 0 &&
+                   index != DataType::String.getIndex();
+        }
+    } // namespace
+
+    MappedFile::MappedFile(const string &path)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        IT_ASSERT(fd >= 0, "Cannot open " + path);
+        struct stat st;
+        IT_ASSERT(fstat(fd, &st) == 0);
+        size = st.st_size;
+        // mmap rejects empty mappings
+        ptr = mmap(nullptr, std::max<size_t>(size, 1), PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE, fd, 0);
+        close(fd);
+        IT_ASSERT(ptr != MAP_FAILED, "Cannot map " + path);
+    }
+
+    MappedFile::~MappedFile() { munmap(ptr, std::max<size_t>(size, 1)); }
+
+    void getOpAttrs(const Operator &op, vector<int> &ints,
+                    vector<float> &floats)
+    {
+        switch (op->getOpType().underlying())
+        {
+        case OpType::Add:
+        case OpType::Sub:
+        case OpType::Mul:
+        case OpType::Div:
+        case OpType::Relu:
+        case OpType::Erf:
+        case OpType::Exp:
+        case OpType::Gelu:
+        case OpType::Log:
+        case OpType::Sigmoid:
+        case OpType::Silu:
+        case OpType::Tanh:
+            break;
+        case OpType::MatMul:
+        case OpType::Transpose:
+        case OpType::Concat:
+        case OpType::Softmax:
+        case OpType::LogSoftmax:
+        case OpType::ReduceSum:
+        case OpType::ReduceMean:
+        case OpType::ReduceMax:
+        case OpType::ReduceMin:
+        case OpType::ReduceProd:
+            ints = op->getOpAttrVector();
+            break;
+        case OpType::Clip:
+        {
+            auto clip = as<ClipObj>(op);
+            ints = {clip->getMin().has_value(), clip->getMax().has_value()};
+            floats = {clip->getMin().value_or(0), clip->getMax().value_or(0)};
+            break;
+        }
+        case OpType::Cast:
+            ints = {(int)as<CastObj>(op)->getType()};
+            break;
+        case OpType::LayerNorm:
+            ints = op->getOpAttrVector();
+            floats = {as<LayerNormObj>(op)->getEpsilon()};
+            break;
+        case OpType::RMSNorm:
+            ints = op->getOpAttrVector();
+            floats = {as<RMSNormObj>(op)->getEpsilon()};
+            break;
+        default:
+            IT_TODO_HALT_MSG(string("Cannot save operator ") +
+                             op->getOpType().toString());
+        }
+    }
+
+    void addOpFromAttrs(GraphObj *g, OpType type, const TensorVec &inputs,
+                        const TensorVec &outputs, const vector<int> &ints,
+                        const vector<float> &floats)
+    {
+        auto input = [&](size_t i) { return inputs.at(i); };
+        auto output = outputs.at(0);
+        // the attributes of reductions are keepDims followed by the axes
+        auto reduceAxes = [&]()
+        { return vector<int>(ints.begin() + 1, ints.end()); };
+        switch (type.underlying())
+        {
+        case OpType::Add:
+            g->addOpWithOutputs<AddObj>(input(0), input(1), output);
+            break;
+        case OpType::Sub:
+            g->addOpWithOutputs<SubObj>(input(0), input(1), output);
+            break;
+        case OpType::Mul:
+            g->addOpWithOutputs<MulObj>(input(0), input(1), output);
+            break;
+        case OpType::Div:
+            g->addOpWithOutputs<DivObj>(input(0), input(1), output);
+            break;
+        case OpType::Relu:
+            g->addOpWithOutputs<ReluObj>(input(0), output);
+            break;
+        case OpType::Erf:
+            g->addOpWithOutputs<ErfObj>(input(0), output);
+            break;
+        case OpType::Exp:
+            g->addOpWithOutputs<ExpObj>(input(0), output);
+            break;
+        case OpType::Gelu:
+            g->addOpWithOutputs<GeluObj>(input(0), output);
+            break;
+        case OpType::Log:
+            g->addOpWithOutputs<LogObj>(input(0), output);
+            break;
+        case OpType::Sigmoid:
+            g->addOpWithOutputs<SigmoidObj>(input(0), output);
+            break;
+        case OpType::Silu:
+            g->addOpWithOutputs<SiluObj>(input(0), output);
+            break;
+        case OpType::Tanh:
+            g->addOpWithOutputs<TanhObj>(input(0), output);
+            break;
+        case OpType::MatMul:
+            g->addOpWithOutputs<MatmulObj>(input(0), input(1), output,
+                                           ints.at(0), ints.at(1));
+            break;
+        case OpType::Transpose:
+            g->addOpWithOutputs<TransposeObj>(input(0), output, ints);
+            break;
+        case OpType::Concat:
+            g->addOpWithOutputs<ConcatObj>(inputs, output, ints.at(0));
+            break;
+        case OpType::Softmax:
+            g->addOpWithOutputs<SoftmaxObj>(input(0), output, ints.at(0));
+            break;
+        case OpType::LayerNorm:
+            g->addOpWithOutputs<LayerNormObj>(
+                input(0), input(1), inputs.size() > 2 ? input(2) : nullptr,
+                output, ints.at(0), floats.at(0));
+            break;
+        case OpType::RMSNorm:
+            g->addOpWithOutputs<RMSNormObj>(input(0), input(1), output,
+                                            ints.at(0), floats.at(0));
+            break;
+        case OpType::LogSoftmax:
+            g->addOpWithOutputs<LogSoftmaxObj>(input(0), output, ints.at(0));
+            break;
+        case OpType::ReduceSum:
+            g->addOpWithOutputs<ReduceSumObj>(input(0), output, reduceAxes(),
+                                              ints.at(0));
+            break;
+        case OpType::ReduceMean:
+            g->addOpWithOutputs<ReduceMeanObj>(input(0), output, reduceAxes(),
+                                               ints.at(0));
+            break;
+        case OpType::ReduceMax:
+            g->addOpWithOutputs<ReduceMaxObj>(input(0), output, reduceAxes(),
+                                              ints.at(0));
+            break;
+        case OpType::ReduceMin:
+            g->addOpWithOutputs<ReduceMinObj>(input(0), output, reduceAxes(),
+                                              ints.at(0));
+            break;
+        case OpType::ReduceProd:
+            g->addOpWithOutputs<ReduceProdObj>(input(0), output, reduceAxes(),
+                                               ints.at(0));
+            break;
+        case OpType::Clip:
+            g->addOpWithOutputs<ClipObj>(
+                input(0), output,
+                ints.at(0) ? std::optional<float>(floats.at(0)) : std::nullopt,
+                ints.at(1) ? std::optional<float>(floats.at(1)) : std::nullopt);
+            break;
+        case OpType::Cast:
+            g->addOpWithOutputs<CastObj>(input(0), output,
+                                         (CastType)ints.at(0));
+            break;
+        default:
+            IT_TODO_HALT_MSG(string("Cannot load operator ") + type.toString());
+        }
+    }
+
+    void saveGraph(const Graph &graph, const string &path,
+                   const TensorVec &weights)
+    {
+        const auto &tensors = graph->getTensors();
+        std::unordered_map<TensorObj *, uint32_t> ids;
+        for (auto &tensor : tensors)
+            ids.emplace(tensor.get(), ids.size());
+        std::unordered_set<TensorObj *> withPayload;
+        for (auto &weight : weights)
+        {
+            IT_ASSERT(ids.count(weight.get()) && weight->hasData(),
+                      "Weights must be bound tensors of the graph");
+            withPayload.insert(weight.get());
+        }
+
+        Writer meta;
+        size_t payloadBytes = 0;
+        meta.write<uint64_t>(tensors.size());
+        for (auto &tensor : tensors)
+        {
+            meta.write<int32_t>(tensor->getDType().getIndex());
+            meta.writeVec<int32_t>(tensor->getDims());
+            bool hasPayload = withPayload.count(tensor.get());
+            meta.write<uint8_t>(hasPayload);
+            meta.write<uint64_t>(hasPayload ? payloadBytes : 0);
+            meta.write<uint64_t>(hasPayload ? tensor->getBytes() : 0);
+            if (hasPayload)
+                payloadBytes = alignUp(payloadBytes + tensor->getBytes());
+        }
+        const auto &ops = graph->getOperators();
+        meta.write<uint64_t>(ops.size());
+        for (auto &op : ops)
+        {
+            meta.write<uint16_t>(op->getOpType().underlying());
+            vector<uint32_t> inputs, outputs;
+            for (auto &input : op->getInputs())
+                inputs.emplace_back(ids.at(input.get()));
+            for (auto &output : op->getOutputs())
+                outputs.emplace_back(ids.at(output.get()));
+            meta.writeVec(inputs);
+            meta.writeVec(outputs);
+            vector<int> ints;
+            vector<float> floats;
+            getOpAttrs(op, ints, floats);
+            meta.writeVec<int32_t>(ints);
+            meta.writeVec(floats);
+        }
+
+        Writer header;
+        size_t payloadOffset =
+            alignUp(graphFileHeaderBytes + meta.str().size());
+        header.write(graphFileMagic);
+        header.write<uint32_t>(graphFileVersion);
+        header.write<uint32_t>(0);
+        header.write<uint64_t>(meta.str().size());
+        header.write<uint64_t>(payloadOffset);
+
+        std::ofstream file(path, std::ios::binary);
+        IT_ASSERT(file.good(), "Cannot write graph file " + path);
+        file << header.str() << meta.str();
+        size_t pos = graphFileHeaderBytes + meta.str().size();
+        for (auto &tensor : tensors)
+        {
+            if (!withPayload.count(tensor.get()))
+                continue;
+            file << string(alignUp(pos) - pos, '\0');
+            pos = alignUp(pos);
+            file.write(tensor->getRawDataPtr<char *>(), tensor->getBytes());
+            pos += tensor->getBytes();
+        }
+        IT_ASSERT(file.good(), "Failed to write graph file " + path);
+    }
+
+    Graph loadGraph(Runtime runtime, const string &path)
+    {
+        auto mapped = make_ref<MappedFile>(path);
+        size_t fileSize = mapped->getSize();
+        IT_ASSERT(fileSize >= graphFileHeaderBytes, "Truncated graph file");
+        auto base = mapped->data();
+
+        Reader header(base, graphFileHeaderBytes);
+        IT_ASSERT(std::memcmp(base, graphFileMagic, sizeof(graphFileMagic)) == 0,
+                  path + " is not a graph file");
+        header.read<std::array<char, sizeof(graphFileMagic)>>();
+        auto version = header.read<uint32_t>();
+        IT_ASSERT(version == graphFileVersion,
+                  "Unsupported graph file version " + std::to_string(version));
+        header.read<uint32_t>();
+        auto metaBytes = header.read<uint64_t>();
+        auto payloadOffset = header.read<uint64_t>();
+        // a file without payload may end right after the metadata, before
+        // payloadOffset
+        IT_ASSERT(metaBytes <= fileSize - graphFileHeaderBytes,
+                  "Truncated graph file");
+
+        Graph g = make_ref<GraphObj>(runtime);
+        Reader meta(base + graphFileHeaderBytes, metaBytes,
+                    graphFileHeaderBytes);
+        // a tensor record holds at least its dtype, rank, payload flag,
+        // offset and size
+        constexpr size_t minTensorRecord = 4 + 4 + 1 + 8 + 8;
+        auto nTensors = meta.read<uint64_t>();
+        meta.check(nTensors <= meta.remaining() / minTensorRecord,
+                   "Invalid tensor count in graph file");
+        TensorVec tensors(nTensors);
+        for (auto &tensor : tensors)
+        {
+            auto dtypeIndex = meta.read<int32_t>();
+            meta.check(isStorableDType(dtypeIndex),
+                       "Invalid data type " + std::to_string(dtypeIndex) +
+                           " in graph file");
+            DataType dtype(dtypeIndex);
+            auto dims = meta.readVec<int32_t>();
+            size_t bytes = dtype.getSize();
+            for (auto dim : dims)
+                meta.check(dim >= 0 && !__builtin_mul_overflow(
+                                           bytes, size_t(dim), &bytes),
+                           "Invalid shape " + vecToString(dims) +
+                               " in graph file");
+            tensor = g->addTensor(Shape(dims.begin(), dims.end()), dtype);
+            bool hasPayload = meta.read<uint8_t>();
+            auto offset = meta.read<uint64_t>();
+            auto payloadBytes = meta.read<uint64_t>();
+            if (!hasPayload)
+                continue;
+            // weights are used in place, so payloads keep the alignment
+            meta.check(payloadBytes == bytes && payloadOffset <= fileSize &&
+                           offset <= fileSize - payloadOffset &&
+                           bytes <= fileSize - payloadOffset - offset &&
+                           payloadOffset % graphFileAlignment == 0 &&
+                           offset % graphFileAlignment == 0,
+                       "Invalid tensor payload in graph file");
+            tensor->setDataBlob(make_ref<BlobObj>(
+                runtime, base + payloadOffset + offset, mapped));
+        }
+        auto nOps = meta.read<uint64_t>();
+        for (size_t i = 0; i < nOps; ++i)
+        {
+            OpType type(meta.read<uint16_t>());
+            meta.check(type != OpType::Unknown &&
+                           string(type.toString()) != "Unknown",
+                       "Invalid operator type " +
+                           std::to_string(type.underlying()) +
+                           " in graph file");
+            TensorVec inputs, outputs;
+            auto tensorAt = [&](uint32_t id)
+            {
+                meta.check(id < tensors.size(),
+                           "Invalid tensor id " + std::to_string(id) +
+                               " in graph file");
+                return tensors[id];
+            };
+            for (auto id : meta.readVec<uint32_t>())
+                inputs.emplace_back(tensorAt(id));
+            for (auto id : meta.readVec<uint32_t>())
+                outputs.emplace_back(tensorAt(id));
+            auto ints = meta.readVec<int32_t>();
+            auto floats = meta.readVec<float>();
+            addOpFromAttrs(g.get(), type, inputs, outputs, ints, floats);
+        }
+        return g;
+    }
+
+} // namespace infini
@@ -0,0 +1,219 @@
+#include "core/thread_pool.h"
+#include <algorithm>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace infini
+{
+    ThreadPool::ThreadPool(size_t nThreads, size_t maxQueued)
+        : maxQueued(maxQueued)
+    {
+        IT_ASSERT(nThreads > 0 && maxQueued > 0);
+        for (size_t i = 0; i < nThreads; ++i)
+            workers.emplace_back([this] { work(); });
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        notEmpty.notify_all();
+        for (auto &worker : workers)
+            worker.join();
+    }
+
+    void ThreadPool::submit(std::function<void()> task)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notFull.wait(lock, [&] { return tasks.size() < maxQueued; });
+            tasks.emplace_back(std::move(task));
+        }
+        notEmpty.notify_one();
+    }
+
+    bool ThreadPool::trySubmit(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (tasks.size() >= maxQueued)
+                return false;
+            tasks.emplace_back(std::move(task));
+        }
+        notEmpty.notify_one();
+        return true;
+    }
+
+    void ThreadPool::work()
+    {
+        currentPool = this;
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                notEmpty.wait(lock, [&] { return stopping || !tasks.empty(); });
+                if (tasks.empty())
+                    return;
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            notFull.notify_one();
+            task();
+        }
+    }
+
+    vector<int> getAllowedCpus()
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        IT_ASSERT(sched_getaffinity(0, sizeof(set), &set) == 0);
+        vector<int> cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            if (CPU_ISSET(cpu, &set))
+                cpus.emplace_back(cpu);
+        return cpus;
+    }
+
+    void pinThread(std::thread &thread, const vector<int> &cpus)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus)
+            CPU_SET(cpu, &set);
+        IT_ASSERT(pthread_setaffinity_np(thread.native_handle(), sizeof(set),
+                                         &set) == 0,
+                  "Cannot pin a thread to cores " + vecToString(cpus));
+    }
+
+    void checkCpus(const vector<int> &cpus)
+    {
+        auto allowed = getAllowedCpus();
+        IT_ASSERT(!cpus.empty(), "Cannot pin a thread to no core");
+        for (int cpu : cpus)
+            IT_ASSERT(std::find(allowed.begin(), allowed.end(), cpu) !=
+                          allowed.end(),
+                      "Cannot pin a thread to cores " + vecToString(cpus));
+    }
+
+    ParallelTeam::ParallelTeam(size_t nThreads, vector<int> cpus)
+        : nThreads(nThreads), cpus(std::move(cpus))
+    {
+        IT_ASSERT(nThreads > 0);
+        // a failure to pin after a worker started would leave it joinable
+        if (!this->cpus.empty())
+            checkCpus(this->cpus);
+        tids.resize(nThreads - 1);
+        for (size_t i = 1; i < nThreads; ++i)
+        {
+            workers.emplace_back([this, i] { work(i); });
+            if (!this->cpus.empty())
+                pinThread(workers.back(), {this->cpus[i % this->cpus.size()]});
+        }
+        // wait for the workers to publish their ids
+        std::unique_lock<std::mutex> lock(mutex);
+        finish.wait(lock, [&] { return started == workers.size(); });
+    }
+
+    ParallelTeam::~ParallelTeam()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        start.notify_all();
+        for (auto &worker : workers)
+            worker.join();
+    }
+
+    void ParallelTeam::runChunk(size_t chunk)
+    {
+        size_t size = jobEnd - jobBegin;
+        size_t chunkBegin = jobBegin + size * chunk / nChunks;
+        size_t chunkEnd = jobBegin + size * (chunk + 1) / nChunks;
+        try
+        {
+            (*job)(chunkBegin, chunkEnd);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+
+    void ParallelTeam::parallelFor(size_t begin, size_t end, size_t grain,
+                                   const std::function<void(size_t, size_t)> &fn)
+    {
+        if (begin >= end)
+            return;
+        size_t chunks =
+            std::min(nThreads, (end - begin) / std::max<size_t>(grain, 1));
+        if (chunks <= 1 || inLoop)
+        {
+            fn(begin, end);
+            return;
+        }
+        std::unique_lock<std::mutex> loopLock(loopMutex, std::try_to_lock);
+        if (!loopLock.owns_lock())
+        {
+            fn(begin, end);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            jobContext = ExecutionContextObj::getCurrent();
+            jobBegin = begin;
+            jobEnd = end;
+            nChunks = chunks;
+            pending = chunks - 1;
+            error = nullptr;
+            ++generation;
+        }
+        start.notify_all();
+        inLoop = true;
+        runChunk(0);
+        inLoop = false;
+        std::unique_lock<std::mutex> lock(mutex);
+        finish.wait(lock, [&] { return pending == 0; });
+        job = nullptr;
+        jobContext = nullptr;
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    void ParallelTeam::work(size_t member)
+    {
+        inLoop = true;
+        size_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        tids[member - 1] = syscall(SYS_gettid);
+        if (++started == nThreads - 1)
+            finish.notify_one();
+        while (true)
+        {
+            start.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+            if (member >= nChunks)
+                continue;
+            const ExecutionContextObj *context = jobContext;
+            lock.unlock();
+            {
+                ExecutionScope scope(context);
+                runChunk(member);
+            }
+            lock.lock();
+            if (--pending == 0)
+                finish.notify_one();
+        }
+    }
+
+} // namespace infini
@@ -32,30 +32,26 @@ class NaiveConcat : public CpuKernelWithoutConfig {
             auto inSize = input->size();
             auto inPtr = input->getRawDataPtr<T *>(),
                  outPtr = output->getRawDataPtr<T *>();
-#pragma omp parallel for
-            for (size_t iOffset = 0; iOffset < inSize; ++iOffset) {
-                auto oOffset = iOffset % localBlockOffset + innerOffset +
-                               iOffset / localBlockOffset * blockOffset;
-                outPtr[oOffset] = inPtr[iOffset];
-            }
+            // The input is a contiguous slice already placed in the output by
+            // the memory planner.
+            if (inSize == localBlockOffset && inPtr == outPtr + innerOffset)
+                continue;
+            context->parallelFor(0, inSize, 1 << 14, [&](size_t begin,
+                                                         size_t end) {
+                for (size_t iOffset = begin; iOffset < end; ++iOffset) {
+                    auto oOffset = iOffset % localBlockOffset + innerOffset +
+                                   iOffset / localBlockOffset * blockOffset;
+                    outPtr[oOffset] = inPtr[iOffset];
+                }
+            });
         }
     }
 
     void compute(const Operator &_op,
                  const RuntimeObj *context) const override {
-#define CASE(N)                                                                \
-    case N:                                                                    \
-        doCompute<DT<N>::t>(_op, context)
-
-        int dataTypeIdx = _op->getDType().getIndex();
-        switch (dataTypeIdx) {
-            CASE(1); // DataType::Float32
-            break;
-            CASE(12); // DataType::UInt32
-            break;
-        default:
-            IT_TODO_HALT();
-        }
+        dispatchDType<CopyableDTypes>(_op->getDType(), [&](auto dt) {
+            doCompute<typename decltype(dt)::t>(_op, context);
+        });
     }
 };
 
@@ -83,32 +83,22 @@ namespace infini
                 IT_TODO_HALT();
             }
 
-            for (size_t i = 0; i < n; ++i)
-            {
-                auto shapeIndexC = locate_index(i, shapeC);
-                auto indexA = delocate_index(shapeIndexC, a, strideA);
-                auto indexB = delocate_index(shapeIndexC, b, strideB);
-                outptr[i] = _doCompute(inptr0[indexA], inptr1[indexB]);
-            }
+            context->parallelFor(0, n, 1 << 12, [&](size_t begin, size_t end)
+                                 {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    auto shapeIndexC = locate_index(i, shapeC);
+                    auto indexA = delocate_index(shapeIndexC, a, strideA);
+                    auto indexB = delocate_index(shapeIndexC, b, strideB);
+                    outptr[i] = _doCompute(inptr0[indexA], inptr1[indexB]);
+                } });
         }
 
         void compute(const Operator &_op,
                      const RuntimeObj *context) const override
         {
-#define CASE(N) \
-    case N:     \
-        doCompute<DT<N>::t>(_op, context)
-
-            int dataTypeIdx = _op->getDType().getIndex();
-            switch (dataTypeIdx)
-            {
-                CASE(1); // DataType::Float32
-                break;
-                CASE(12); // DataType::UInt32
-                break;
-            default:
-                IT_TODO_HALT();
-            }
+            dispatchDType<NumericDTypes>(_op->getDType(), [&](auto dt)
+                                         { doCompute<typename decltype(dt)::t>(_op, context); });
         }
     };
 
@@ -0,0 +1,164 @@
+#include "operators/matmul.h"
+#include "core/kernel.h"
+#include "utils/operator_utils.h"
+
+namespace infini
+{
+    /**
+     * @brief Call f(offsetA, offsetB, offsetC) for every matrix of a batched
+     * matmul, broadcasting the batch dimensions of A and B to the output.
+     */
+    template <typename F>
+    static void forEachMatmulBatch(const MatmulObj &op, F &&f)
+    {
+        auto shapeC = op.getOutput()->getDims();
+        size_t batchRank = shapeC.size() - 2;
+        auto getBatch = [&](const Shape &shape)
+        {
+            Shape batch(batchRank, 1);
+            std::copy(shape.begin(), shape.end() - 2,
+                      batch.end() - (shape.size() - 2));
+            return batch;
+        };
+        auto getStride = [&](const Shape &shape)
+        {
+            int p = 1;
+            Shape stride(batchRank);
+            for (auto i = batchRank; i > 0; --i)
+            {
+                stride[i - 1] = p;
+                p = p * shape[i - 1];
+            }
+            return stride;
+        };
+        Shape batchA = getBatch(op.getInputs(0)->getDims());
+        Shape batchB = getBatch(op.getInputs(1)->getDims());
+        Shape batchC = getBatch(shapeC);
+        Shape strideA = getStride(batchA), strideB = getStride(batchB);
+        size_t m = op.getM(), n = op.getN(), k = op.getK();
+        size_t nBatch = op.getOutput()->size() / (m * n);
+        for (size_t i = 0; i < nBatch; ++i)
+        {
+            auto index = locate_index(i, batchC);
+            f(delocate_index(index, batchA, strideA) * m * k,
+              delocate_index(index, batchB, strideB) * k * n, i * m * n);
+        }
+    }
+
+    /**
+     * @brief Cache-blocked matmul. B is packed tile by tile into a contiguous
+     * buffer so that the innermost loop streams over rows of C and of the
+     * packed tile whatever the transposition of B.
+     */
+    class BlockedMatmul : public CpuKernelWithoutConfig
+    {
+        static constexpr size_t blockN = 256, blockK = 128;
+        // Below this m * n * k the packing overhead is not amortized.
+        static constexpr size_t minWorkload = 32 * 32 * 32;
+
+        bool isApplicable(const Operator &_op) const override
+        {
+            auto op = as<MatmulObj>(_op);
+            return (size_t)op->getM() * op->getN() * op->getK() >= minWorkload;
+        }
+
+        template <typename T>
+        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        {
+            auto op = as<MatmulObj>(_op);
+            T *ptrA = op->getInputs(0)->getRawDataPtr<T *>();
+            T *ptrB = op->getInputs(1)->getRawDataPtr<T *>();
+            T *ptrC = op->getOutput()->getRawDataPtr<T *>();
+            size_t m = op->getM(), n = op->getN(), k = op->getK();
+            bool transA = op->getTransA(), transB = op->getTransB();
+            // rows of C are split among threads, each packing its own tiles
+            size_t rowGrain = std::max<size_t>(1, minWorkload / (n * k));
+
+            forEachMatmulBatch(*op, [&](size_t offA, size_t offB, size_t offC)
+                               { context->parallelFor(0, m, rowGrain, [&](size_t i0, size_t i1)
+                                                      {
+                const T *A = ptrA + offA, *B = ptrB + offB;
+                T *C = ptrC + offC;
+                vector<T> packed(blockK * blockN);
+                std::fill(C + i0 * n, C + i1 * n, T(0));
+                for (size_t j0 = 0; j0 < n; j0 += blockN)
+                {
+                    size_t nj = std::min(blockN, n - j0);
+                    for (size_t p0 = 0; p0 < k; p0 += blockK)
+                    {
+                        size_t np = std::min(blockK, k - p0);
+                        for (size_t p = 0; p < np; ++p)
+                            for (size_t j = 0; j < nj; ++j)
+                                packed[p * blockN + j] =
+                                    transB ? B[(j0 + j) * k + p0 + p]
+                                           : B[(p0 + p) * n + j0 + j];
+                        for (size_t i = i0; i < i1; ++i)
+                        {
+                            T *c = C + i * n + j0;
+                            for (size_t p = 0; p < np; ++p)
+                            {
+                                T a = transA ? A[(p0 + p) * m + i]
+                                             : A[i * k + p0 + p];
+                                const T *b = packed.data() + p * blockN;
+                                for (size_t j = 0; j < nj; ++j)
+                                    c[j] += a * b[j];
+                            }
+                        }
+                    }
+                } }); });
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            dispatchDType<NumericDTypes>(_op->getDType(), [&](auto dt)
+                                         { doCompute<typename decltype(dt)::t>(_op, context); });
+        }
+    };
+
+    class NaiveMatmul : public CpuKernelWithoutConfig
+    {
+        template <typename T>
+        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        {
+            auto op = as<MatmulObj>(_op);
+            T *ptrA = op->getInputs(0)->getRawDataPtr<T *>();
+            T *ptrB = op->getInputs(1)->getRawDataPtr<T *>();
+            T *ptrC = op->getOutput()->getRawDataPtr<T *>();
+            size_t m = op->getM(), n = op->getN(), k = op->getK();
+            bool transA = op->getTransA(), transB = op->getTransB();
+
+            size_t rowGrain = std::max<size_t>(1, (1 << 15) / (n * k));
+
+            forEachMatmulBatch(*op, [&](size_t offA, size_t offB, size_t offC)
+                               { context->parallelFor(0, m, rowGrain, [&](size_t i0, size_t i1)
+                                                      {
+                const T *A = ptrA + offA, *B = ptrB + offB;
+                T *C = ptrC + offC;
+                for (size_t i = i0; i < i1; ++i)
+                    for (size_t j = 0; j < n; ++j)
+                    {
+                        T sum = 0;
+                        for (size_t p = 0; p < k; ++p)
+                            sum += (transA ? A[p * m + i] : A[i * k + p]) *
+                                   (transB ? B[j * k + p] : B[p * n + j]);
+                        C[i * n + j] = sum;
+                    } }); });
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            dispatchDType<NumericDTypes>(_op->getDType(), [&](auto dt)
+                                         { doCompute<typename decltype(dt)::t>(_op, context); });
+        }
+    };
+
+    // Kernels of one key are tried in registration order, keep the more
+    // specialized one first.
+    REGISTER_KERNEL(Device::CPU, OpType::MatMul, BlockedMatmul,
+                    "matmulBlocked_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::MatMul, NaiveMatmul,
+                    "matmulNaive_CPU");
+
+}; // namespace infini
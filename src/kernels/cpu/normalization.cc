@@ -0,0 +1,117 @@
+#include "operators/normalization.h"
+#include "core/kernel.h"
+#include <cmath>
+
+namespace infini
+{
+    /**
+     * @brief LayerNorm with the mean and the variance of a row from one
+     * Welford pass, and the normalization, scale and bias applied in a
+     * second pass over the row.
+     */
+    class NativeLayerNorm : public CpuKernelWithoutConfig
+    {
+        template <typename T>
+        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        {
+            auto op = as<LayerNormObj>(_op);
+            T *inptr = op->getInputs(0)->getRawDataPtr<T *>();
+            T *scale = op->getInputs(1)->getRawDataPtr<T *>();
+            T *bias =
+                op->hasBias() ? op->getInputs(2)->getRawDataPtr<T *>() : nullptr;
+            T *outptr = op->getOutput()->getRawDataPtr<T *>();
+            T epsilon = op->getEpsilon();
+
+            size_t len = op->getInputs(1)->size();
+            size_t rows = op->getInputs(0)->size() / len;
+            context->parallelFor(0, rows, std::max<size_t>(1, (1 << 14) / len),
+                                 [&](size_t begin, size_t end)
+                                 {
+                for (size_t r = begin; r < end; ++r)
+                {
+                    const T *x = inptr + r * len;
+                    T *y = outptr + r * len;
+                    // the statistics are kept in double, the sequential
+                    // updates would round a float mean len times
+                    double mean = 0, m2 = 0;
+                    for (size_t i = 0; i < len; ++i)
+                    {
+                        double delta = x[i] - mean;
+                        mean += delta / double(i + 1);
+                        m2 += delta * (x[i] - mean);
+                    }
+                    T rstd = 1 / std::sqrt(T(m2 / double(len)) + epsilon);
+                    T shift = mean;
+                    for (size_t i = 0; i < len; ++i)
+                        y[i] = (x[i] - shift) * rstd * scale[i] +
+                               (bias ? bias[i] : T(0));
+                } });
+        }
+
+        bool isApplicable(const Operator &op) const override
+        {
+            return op->getDType() == DataType::Float32 ||
+                   op->getDType() == DataType::Double;
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            dispatchDType<FloatDTypes>(_op->getDType(), [&](auto dt)
+                                       { doCompute<typename decltype(dt)::t>(_op, context); });
+        }
+    };
+
+    /**
+     * @brief RMSNorm with the mean square of a row from one pass, and the
+     * normalization and scale applied in a second pass over the row.
+     */
+    class NativeRMSNorm : public CpuKernelWithoutConfig
+    {
+        template <typename T>
+        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        {
+            auto op = as<RMSNormObj>(_op);
+            T *inptr = op->getInputs(0)->getRawDataPtr<T *>();
+            T *scale = op->getInputs(1)->getRawDataPtr<T *>();
+            T *outptr = op->getOutput()->getRawDataPtr<T *>();
+            T epsilon = op->getEpsilon();
+
+            size_t len = op->getInputs(1)->size();
+            size_t rows = op->getInputs(0)->size() / len;
+            context->parallelFor(0, rows, std::max<size_t>(1, (1 << 14) / len),
+                                 [&](size_t begin, size_t end)
+                                 {
+                for (size_t r = begin; r < end; ++r)
+                {
+                    const T *x = inptr + r * len;
+                    T *y = outptr + r * len;
+                    double sum = 0;
+                    for (size_t i = 0; i < len; ++i)
+                        sum += double(x[i]) * x[i];
+                    T rstd = 1 / std::sqrt(T(sum / double(len)) + epsilon);
+                    for (size_t i = 0; i < len; ++i)
+                        y[i] = x[i] * rstd * scale[i];
+                } });
+        }
+
+        bool isApplicable(const Operator &op) const override
+        {
+            return op->getDType() == DataType::Float32 ||
+                   op->getDType() == DataType::Double;
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            dispatchDType<FloatDTypes>(_op->getDType(), [&](auto dt)
+                                       { doCompute<typename decltype(dt)::t>(_op, context); });
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::LayerNorm, NativeLayerNorm,
+                    "layerNormNaive_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::RMSNorm, NativeRMSNorm,
+                    "rmsNormNaive_CPU");
+
+}; // namespace infini
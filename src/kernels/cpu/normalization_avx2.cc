@@ -0,0 +1,196 @@
+#include "operators/normalization.h"
+#include "core/kernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include "transcendental_avx2.h"
+
+namespace infini
+{
+    /**
+     * @brief LayerNorm for hosts with AVX2 and FMA, on Float32 only. Each
+     * lane of two vectors runs Welford's update on its own elements of the
+     * row, and the 16 partial results are merged with Chan's formula.
+     */
+    class Avx2LayerNorm : public CpuKernelWithoutConfig
+    {
+        // the mean and the sum of squared deviations of count elements
+        struct Moments
+        {
+            float count = 0, mean = 0, m2 = 0;
+
+            void merge(float otherCount, float otherMean, float otherM2)
+            {
+                if (otherCount == 0)
+                    return;
+                float total = count + otherCount;
+                float delta = otherMean - mean;
+                mean += delta * (otherCount / total);
+                m2 += otherM2 + delta * delta * (count * otherCount / total);
+                count = total;
+            }
+        };
+
+        AVX2_FMA static void row(const float *x, const float *scale,
+                                 const float *bias, float *y, size_t len,
+                                 float epsilon)
+        {
+            // two independent chains hide the latency of the updates
+            __m256 mean0 = _mm256_setzero_ps(), m20 = _mm256_setzero_ps();
+            __m256 mean1 = _mm256_setzero_ps(), m21 = _mm256_setzero_ps();
+            size_t i = 0, count0 = 0, count1 = 0;
+            for (; i + 16 <= len; i += 16)
+            {
+                __m256 rcp = _mm256_set1_ps(1.f / float(++count0));
+                ++count1;
+                __m256 v0 = _mm256_loadu_ps(x + i);
+                __m256 v1 = _mm256_loadu_ps(x + i + 8);
+                __m256 delta0 = _mm256_sub_ps(v0, mean0);
+                __m256 delta1 = _mm256_sub_ps(v1, mean1);
+                mean0 = _mm256_fmadd_ps(delta0, rcp, mean0);
+                mean1 = _mm256_fmadd_ps(delta1, rcp, mean1);
+                m20 = _mm256_fmadd_ps(delta0, _mm256_sub_ps(v0, mean0), m20);
+                m21 = _mm256_fmadd_ps(delta1, _mm256_sub_ps(v1, mean1), m21);
+            }
+            if (i + 8 <= len)
+            {
+                __m256 v0 = _mm256_loadu_ps(x + i);
+                __m256 delta0 = _mm256_sub_ps(v0, mean0);
+                mean0 = _mm256_fmadd_ps(
+                    delta0, _mm256_set1_ps(1.f / float(++count0)), mean0);
+                m20 = _mm256_fmadd_ps(delta0, _mm256_sub_ps(v0, mean0), m20);
+                i += 8;
+            }
+
+            float means[16], m2s[16];
+            _mm256_storeu_ps(means, mean0);
+            _mm256_storeu_ps(means + 8, mean1);
+            _mm256_storeu_ps(m2s, m20);
+            _mm256_storeu_ps(m2s + 8, m21);
+            Moments moments;
+            for (int lane = 0; lane < 16; ++lane)
+                moments.merge(lane < 8 ? count0 : count1, means[lane],
+                              m2s[lane]);
+            for (; i < len; ++i)
+                moments.merge(1, x[i], 0);
+
+            float rstd = 1.f / std::sqrt(moments.m2 / float(len) + epsilon);
+            const __m256 vmean = _mm256_set1_ps(moments.mean);
+            const __m256 vrstd = _mm256_set1_ps(rstd);
+            for (i = 0; i + 8 <= len; i += 8)
+            {
+                __m256 v = _mm256_mul_ps(
+                    _mm256_sub_ps(_mm256_loadu_ps(x + i), vmean), vrstd);
+                __m256 b = bias ? _mm256_loadu_ps(bias + i)
+                                : _mm256_setzero_ps();
+                _mm256_storeu_ps(
+                    y + i, _mm256_fmadd_ps(v, _mm256_loadu_ps(scale + i), b));
+            }
+            for (; i < len; ++i)
+                y[i] = (x[i] - moments.mean) * rstd * scale[i] +
+                       (bias ? bias[i] : 0.f);
+        }
+
+        bool isApplicable(const Operator &op) const override
+        {
+            return op->getDType() == DataType::Float32;
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            auto op = as<LayerNormObj>(_op);
+            auto inptr = op->getInputs(0)->getRawDataPtr<float *>();
+            auto scale = op->getInputs(1)->getRawDataPtr<float *>();
+            auto bias = op->hasBias()
+                            ? op->getInputs(2)->getRawDataPtr<float *>()
+                            : nullptr;
+            auto outptr = op->getOutput()->getRawDataPtr<float *>();
+            float epsilon = op->getEpsilon();
+
+            size_t len = op->getInputs(1)->size();
+            size_t rows = op->getInputs(0)->size() / len;
+            context->parallelFor(
+                0, rows, std::max<size_t>(1, (1 << 14) / len),
+                [&](size_t begin, size_t end)
+                {
+                    for (size_t r = begin; r < end; ++r)
+                        row(inptr + r * len, scale, bias, outptr + r * len,
+                            len, epsilon);
+                });
+        }
+    };
+
+    /**
+     * @brief RMSNorm for hosts with AVX2 and FMA, on Float32 only.
+     */
+    class Avx2RMSNorm : public CpuKernelWithoutConfig
+    {
+        AVX2_FMA static void row(const float *x, const float *scale, float *y,
+                                 size_t len, float epsilon)
+        {
+            // four accumulators hide the latency of the fma
+            __m256 acc[4] = {_mm256_setzero_ps(), _mm256_setzero_ps(),
+                             _mm256_setzero_ps(), _mm256_setzero_ps()};
+            size_t i = 0;
+            for (; i + 32 <= len; i += 32)
+                for (int u = 0; u < 4; ++u)
+                {
+                    __m256 v = _mm256_loadu_ps(x + i + u * 8);
+                    acc[u] = _mm256_fmadd_ps(v, v, acc[u]);
+                }
+            for (; i + 8 <= len; i += 8)
+            {
+                __m256 v = _mm256_loadu_ps(x + i);
+                acc[0] = _mm256_fmadd_ps(v, v, acc[0]);
+            }
+            float sum = avx2::hsum(_mm256_add_ps(_mm256_add_ps(acc[0], acc[1]),
+                                                 _mm256_add_ps(acc[2], acc[3])));
+            for (; i < len; ++i)
+                sum += x[i] * x[i];
+
+            float rstd = 1.f / std::sqrt(sum / float(len) + epsilon);
+            const __m256 vrstd = _mm256_set1_ps(rstd);
+            for (i = 0; i + 8 <= len; i += 8)
+                _mm256_storeu_ps(
+                    y + i, _mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(x + i),
+                                                       vrstd),
+                                         _mm256_loadu_ps(scale + i)));
+            for (; i < len; ++i)
+                y[i] = x[i] * rstd * scale[i];
+        }
+
+        bool isApplicable(const Operator &op) const override
+        {
+            return op->getDType() == DataType::Float32;
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            auto op = as<RMSNormObj>(_op);
+            auto inptr = op->getInputs(0)->getRawDataPtr<float *>();
+            auto scale = op->getInputs(1)->getRawDataPtr<float *>();
+            auto outptr = op->getOutput()->getRawDataPtr<float *>();
+            float epsilon = op->getEpsilon();
+
+            size_t len = op->getInputs(1)->size();
+            size_t rows = op->getInputs(0)->size() / len;
+            context->parallelFor(
+                0, rows, std::max<size_t>(1, (1 << 14) / len),
+                [&](size_t begin, size_t end)
+                {
+                    for (size_t r = begin; r < end; ++r)
+                        row(inptr + r * len, scale, outptr + r * len, len,
+                            epsilon);
+                });
+        }
+    };
+
+    REGISTER_KERNEL_ISA(Device::CPU, OpType::LayerNorm, IsaLevel::AVX2,
+                        Avx2LayerNorm, "layerNormAvx2_CPU");
+    REGISTER_KERNEL_ISA(Device::CPU, OpType::RMSNorm, IsaLevel::AVX2,
+                        Avx2RMSNorm, "rmsNormAvx2_CPU");
+
+}; // namespace infini
+
+#endif
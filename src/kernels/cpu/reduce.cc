@@ -0,0 +1,60 @@
+#include "core/kernel.h"
+#include "reduce_plan.h"
+
+namespace infini
+{
+    class NativeReduce : public CpuKernelWithoutConfig
+    {
+        template <typename T, typename Reducer>
+        static void run(const ReduceObj &op, const RuntimeObj *context)
+        {
+            computeReduce<T, Reducer, ScalarReduceLoops<T, Reducer>>(op,
+                                                                      context);
+        }
+
+        template <typename T>
+        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        {
+            auto op = as<ReduceObj>(_op);
+            switch (op->getOpType().underlying())
+            {
+            case OpType::ReduceSum:
+                run<T, SumReducer>(*op, context);
+                break;
+            case OpType::ReduceMean:
+                run<T, MeanReducer>(*op, context);
+                break;
+            case OpType::ReduceMax:
+                run<T, MaxReducer>(*op, context);
+                break;
+            case OpType::ReduceMin:
+                run<T, MinReducer>(*op, context);
+                break;
+            case OpType::ReduceProd:
+                run<T, ProdReducer>(*op, context);
+                break;
+            default:
+                IT_TODO_HALT();
+            }
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            dispatchDType<NumericDTypes>(_op->getDType(), [&](auto dt)
+                                         { doCompute<typename decltype(dt)::t>(_op, context); });
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::ReduceSum, NativeReduce,
+                    "reduceSumNaive_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::ReduceMean, NativeReduce,
+                    "reduceMeanNaive_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::ReduceMax, NativeReduce,
+                    "reduceMaxNaive_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::ReduceMin, NativeReduce,
+                    "reduceMinNaive_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::ReduceProd, NativeReduce,
+                    "reduceProdNaive_CPU");
+
+}; // namespace infini
@@ -0,0 +1,141 @@
+#include "core/kernel.h"
+#include "reduce_plan.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include "transcendental_avx2.h"
+
+namespace infini
+{
+    // the combination of each reduction on 8 floats
+    struct Avx2Sum
+    {
+        AVX2_FMA static __m256 combine(__m256 a, __m256 b)
+        {
+            return _mm256_add_ps(a, b);
+        }
+    };
+
+    struct Avx2Max
+    {
+        AVX2_FMA static __m256 combine(__m256 a, __m256 b)
+        {
+            return _mm256_max_ps(a, b);
+        }
+    };
+
+    struct Avx2Min
+    {
+        AVX2_FMA static __m256 combine(__m256 a, __m256 b)
+        {
+            return _mm256_min_ps(a, b);
+        }
+    };
+
+    struct Avx2Prod
+    {
+        AVX2_FMA static __m256 combine(__m256 a, __m256 b)
+        {
+            return _mm256_mul_ps(a, b);
+        }
+    };
+
+    // ScalarReduceLoops of Float32 with AVX2
+    template <typename Reducer, typename Vec> struct Avx2ReduceLoops
+    {
+        AVX2_FMA static float reduceRow(const float *x, size_t n)
+        {
+            // four accumulators hide the latency of the combinations
+            const __m256 identity =
+                _mm256_set1_ps(Reducer::template identity<float>());
+            __m256 acc[4] = {identity, identity, identity, identity};
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32)
+                for (int u = 0; u < 4; ++u)
+                    acc[u] = Vec::combine(acc[u], _mm256_loadu_ps(x + i + u * 8));
+            for (; i + 8 <= n; i += 8)
+                acc[0] = Vec::combine(acc[0], _mm256_loadu_ps(x + i));
+            acc[0] = Vec::combine(Vec::combine(acc[0], acc[1]),
+                                  Vec::combine(acc[2], acc[3]));
+            // the horizontal reduction of the lanes
+            __m128 half = _mm256_extractf128_ps(acc[0], 1);
+            float lanes[8];
+            _mm_storeu_ps(lanes, half);
+            _mm_storeu_ps(lanes + 4, _mm256_castps256_ps128(acc[0]));
+            float result = lanes[0];
+            for (int l = 1; l < 8; ++l)
+                result = Reducer::combine(result, lanes[l]);
+            for (; i < n; ++i)
+                result = Reducer::combine(result, x[i]);
+            return result;
+        }
+
+        AVX2_FMA static void accumulate(float *acc, const float *x, size_t n)
+        {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+                _mm256_storeu_ps(acc + i,
+                                 Vec::combine(_mm256_loadu_ps(acc + i),
+                                              _mm256_loadu_ps(x + i)));
+            for (; i < n; ++i)
+                acc[i] = Reducer::combine(acc[i], x[i]);
+        }
+    };
+
+    /**
+     * @brief The reductions for hosts with AVX2, on Float32 only.
+     */
+    class Avx2Reduce : public CpuKernelWithoutConfig
+    {
+        template <typename Reducer, typename Vec>
+        static void run(const ReduceObj &op, const RuntimeObj *context)
+        {
+            computeReduce<float, Reducer, Avx2ReduceLoops<Reducer, Vec>>(
+                op, context);
+        }
+
+        bool isApplicable(const Operator &op) const override
+        {
+            return op->getDType() == DataType::Float32;
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            auto op = as<ReduceObj>(_op);
+            switch (op->getOpType().underlying())
+            {
+            case OpType::ReduceSum:
+                run<SumReducer, Avx2Sum>(*op, context);
+                break;
+            case OpType::ReduceMean:
+                run<MeanReducer, Avx2Sum>(*op, context);
+                break;
+            case OpType::ReduceMax:
+                run<MaxReducer, Avx2Max>(*op, context);
+                break;
+            case OpType::ReduceMin:
+                run<MinReducer, Avx2Min>(*op, context);
+                break;
+            case OpType::ReduceProd:
+                run<ProdReducer, Avx2Prod>(*op, context);
+                break;
+            default:
+                IT_TODO_HALT();
+            }
+        }
+    };
+
+    REGISTER_KERNEL_ISA(Device::CPU, OpType::ReduceSum, IsaLevel::AVX2,
+                        Avx2Reduce, "reduceSumAvx2_CPU");
+    REGISTER_KERNEL_ISA(Device::CPU, OpType::ReduceMean, IsaLevel::AVX2,
+                        Avx2Reduce, "reduceMeanAvx2_CPU");
+    REGISTER_KERNEL_ISA(Device::CPU, OpType::ReduceMax, IsaLevel::AVX2,
+                        Avx2Reduce, "reduceMaxAvx2_CPU");
+    REGISTER_KERNEL_ISA(Device::CPU, OpType::ReduceMin, IsaLevel::AVX2,
+                        Avx2Reduce, "reduceMinAvx2_CPU");
+    REGISTER_KERNEL_ISA(Device::CPU, OpType::ReduceProd, IsaLevel::AVX2,
+                        Avx2Reduce, "reduceProdAvx2_CPU");
+
+}; // namespace infini
+
+#endif
@@ -0,0 +1,262 @@
+#pragma once
+#include "core/runtime.h"
+#include "operators/reduce.h"
+#include <limits>
+
+namespace infini
+{
+    // The combination, identity and final scaling of each reduction.
+    struct SumReducer
+    {
+        template <typename T> static T identity() { return T(0); }
+        template <typename T> static T combine(T a, T b) { return a + b; }
+        template <typename T> static T finalize(T val, size_t) { return val; }
+    };
+
+    struct MeanReducer : SumReducer
+    {
+        template <typename T> static T finalize(T val, size_t count)
+        {
+            return val / T(count);
+        }
+    };
+
+    struct MaxReducer
+    {
+        // -inf, so that rows of -inf reduce to -inf
+        template <typename T> static T identity()
+        {
+            if constexpr (std::numeric_limits<T>::has_infinity)
+                return -std::numeric_limits<T>::infinity();
+            else
+                return std::numeric_limits<T>::lowest();
+        }
+        template <typename T> static T combine(T a, T b)
+        {
+            return std::max(a, b);
+        }
+        template <typename T> static T finalize(T val, size_t) { return val; }
+    };
+
+    struct MinReducer
+    {
+        template <typename T> static T identity()
+        {
+            if constexpr (std::numeric_limits<T>::has_infinity)
+                return std::numeric_limits<T>::infinity();
+            else
+                return std::numeric_limits<T>::max();
+        }
+        template <typename T> static T combine(T a, T b)
+        {
+            return std::min(a, b);
+        }
+        template <typename T> static T finalize(T val, size_t) { return val; }
+    };
+
+    struct ProdReducer
+    {
+        template <typename T> static T identity() { return T(1); }
+        template <typename T> static T combine(T a, T b) { return a * b; }
+        template <typename T> static T finalize(T val, size_t) { return val; }
+    };
+
+    /**
+     * @brief Scalar loops of a reduction, written with independent lanes so
+     * that the compiler may vectorize them. Kernels for an ISA provide the
+     * same two functions with intrinsics.
+     */
+    template <typename T, typename Reducer> struct ScalarReduceLoops
+    {
+        // the reduction of n contiguous elements
+        static T reduceRow(const T *x, size_t n)
+        {
+            constexpr size_t lanes = 8;
+            T acc[lanes];
+            std::fill_n(acc, lanes, Reducer::template identity<T>());
+            size_t i = 0;
+            for (; i + lanes <= n; i += lanes)
+                for (size_t l = 0; l < lanes; ++l)
+                    acc[l] = Reducer::combine(acc[l], x[i + l]);
+            for (; i < n; ++i)
+                acc[0] = Reducer::combine(acc[0], x[i]);
+            for (size_t l = 1; l < lanes; ++l)
+                acc[0] = Reducer::combine(acc[0], acc[l]);
+            return acc[0];
+        }
+
+        // acc[i] = combine(acc[i], x[i]) for n contiguous columns
+        static void accumulate(T *acc, const T *x, size_t n)
+        {
+            for (size_t i = 0; i < n; ++i)
+                acc[i] = Reducer::combine(acc[i], x[i]);
+        }
+    };
+
+    /**
+     * @brief How a reduction walks its input. Dims of size 1 are dropped and
+     * adjacent dims which are both reduced or both kept are merged, so the
+     * input is a list of alternating kept and reduced groups. The innermost
+     * group decides the strategy:
+     *
+     * - everything reduced: a parallel tree over chunks of the input;
+     * - innermost reduced: each output reduces contiguous rows with
+     *   reduceRow, outputs are split among the threads;
+     * - innermost kept: each block of contiguous outputs accumulates rows of
+     *   columns with accumulate, column chunks are split among the threads.
+     */
+    class ReducePlan
+    {
+        // the kept groups not handled by the innermost loop, with their
+        // input strides, outermost first
+        vector<size_t> keptSizes, keptStrides;
+
+    public:
+        // the length of the innermost group
+        size_t inner = 1;
+        bool innerReduced = false;
+        // the number of outputs, and of inputs combined into each one
+        size_t outputs = 1, count = 1;
+        // input offsets of every combination of the reduced groups not
+        // handled by the innermost loop
+        vector<size_t> reducedOffsets{0};
+
+        explicit ReducePlan(const ReduceObj &op)
+        {
+            auto dims = op.getInputs(0)->getDims();
+            vector<size_t> sizes;
+            vector<bool> reduced;
+            for (size_t i = 0; i < dims.size(); ++i)
+            {
+                if (dims[i] == 1)
+                    continue;
+                bool isReduced = op.isReduced(i);
+                if (!reduced.empty() && reduced.back() == isReduced)
+                    sizes.back() *= dims[i];
+                else
+                {
+                    sizes.emplace_back(dims[i]);
+                    reduced.emplace_back(isReduced);
+                }
+            }
+            if (sizes.empty())
+                return;
+
+            inner = sizes.back();
+            innerReduced = reduced.back();
+            size_t stride = inner;
+            for (int g = int(sizes.size()) - 2; g >= 0; --g)
+            {
+                if (reduced[g])
+                {
+                    size_t n = reducedOffsets.size();
+                    for (size_t k = 1; k < sizes[g]; ++k)
+                        for (size_t j = 0; j < n; ++j)
+                            reducedOffsets.emplace_back(reducedOffsets[j] +
+                                                        k * stride);
+                }
+                else
+                {
+                    keptSizes.insert(keptSizes.begin(), sizes[g]);
+                    keptStrides.insert(keptStrides.begin(), stride);
+                }
+                stride *= sizes[g];
+            }
+            outputs = op.getOutput()->size();
+            count = op.getInputs(0)->size() / outputs;
+        }
+
+        bool isFull() const { return innerReduced && outputs == 1; }
+
+        // the input offset of the o-th combination of the kept groups not
+        // handled by the innermost loop
+        size_t keptOffset(size_t o) const
+        {
+            size_t offset = 0;
+            for (int g = int(keptSizes.size()) - 1; g >= 0; --g)
+            {
+                offset += o % keptSizes[g] * keptStrides[g];
+                o /= keptSizes[g];
+            }
+            return offset;
+        }
+    };
+
+    /**
+     * @brief Run a reduction with the strategy of its ReducePlan. Loops is
+     * ScalarReduceLoops or a vectorized equivalent.
+     */
+    template <typename T, typename Reducer, typename Loops>
+    void computeReduce(const ReduceObj &op, const RuntimeObj *context)
+    {
+        T *inptr = op.getInputs(0)->getRawDataPtr<T *>();
+        T *outptr = op.getOutput()->getRawDataPtr<T *>();
+        ReducePlan plan(op);
+        const auto &reducedOffsets = plan.reducedOffsets;
+        const size_t grainElements = 1 << 14;
+
+        if (plan.isFull())
+        {
+            // per-chunk partial results, combined by a tree
+            size_t n = plan.inner;
+            size_t chunk = std::max(
+                grainElements, (n + 4 * context->getThreadCount() - 1) /
+                                   (4 * context->getThreadCount()));
+            size_t nChunks = (n + chunk - 1) / chunk;
+            vector<T> partial(nChunks);
+            context->parallelFor(0, nChunks, 1,
+                                 [&](size_t begin, size_t end)
+                                 {
+                for (size_t c = begin; c < end; ++c)
+                    partial[c] = Loops::reduceRow(
+                        inptr + c * chunk, std::min(chunk, n - c * chunk)); });
+            for (size_t step = 1; step < nChunks; step *= 2)
+                for (size_t c = 0; c + step < nChunks; c += 2 * step)
+                    partial[c] =
+                        Reducer::combine(partial[c], partial[c + step]);
+            *outptr = Reducer::finalize(partial[0], plan.count);
+            return;
+        }
+
+        if (plan.innerReduced)
+        {
+            size_t grain = std::max<size_t>(1, grainElements / plan.count);
+            context->parallelFor(0, plan.outputs, grain,
+                                 [&](size_t begin, size_t end)
+                                 {
+                for (size_t o = begin; o < end; ++o)
+                {
+                    const T *base = inptr + plan.keptOffset(o);
+                    T acc = Reducer::template identity<T>();
+                    for (size_t offset : reducedOffsets)
+                        acc = Reducer::combine(
+                            acc, Loops::reduceRow(base + offset, plan.inner));
+                    outptr[o] = Reducer::finalize(acc, plan.count);
+                } });
+            return;
+        }
+
+        // blocks of inner contiguous outputs, split into column chunks
+        size_t blocks = plan.outputs / plan.inner;
+        size_t columns = std::min<size_t>(plan.inner, 1024);
+        size_t chunks = (plan.inner + columns - 1) / columns;
+        size_t grain =
+            std::max<size_t>(1, grainElements / (plan.count * columns));
+        context->parallelFor(0, blocks * chunks, grain,
+                             [&](size_t begin, size_t end)
+                             {
+            for (size_t task = begin; task < end; ++task)
+            {
+                size_t b = task / chunks, c = task % chunks * columns;
+                size_t n = std::min(columns, plan.inner - c);
+                const T *base = inptr + plan.keptOffset(b) + c;
+                T *acc = outptr + b * plan.inner + c;
+                std::fill_n(acc, n, Reducer::template identity<T>());
+                for (size_t offset : reducedOffsets)
+                    Loops::accumulate(acc, base + offset, n);
+                for (size_t i = 0; i < n; ++i)
+                    acc[i] = Reducer::finalize(acc[i], plan.count);
+            } });
+    }
+
+} // namespace infini
@@ -0,0 +1,106 @@
+#include "operators/softmax.h"
+#include "core/kernel.h"
+#include "transcendental.h"
+
+namespace infini
+{
+    /**
+     * @brief Softmax and LogSoftmax. The input is viewed as [outer, len,
+     * inner] around the axis; the rows along the axis are normalized with a
+     * pass for the max, one for the sum of the exponentials and one for the
+     * outputs. Float32 uses the approximations of the unary kernels, Float64
+     * uses libm.
+     */
+    class NativeSoftmax : public CpuKernelWithoutConfig
+    {
+        // columns normalized together when the axis is not the last dim
+        static constexpr size_t blockColumns = 64;
+
+        static float expCompute(float val) { return approx::exp(val); }
+        static double expCompute(double val) { return std::exp(val); }
+        static float logCompute(float val) { return approx::log(val); }
+        static double logCompute(double val) { return std::log(val); }
+
+        // the count adjacent rows along the axis starting at inptr, whose
+        // len elements are stride apart
+        template <typename T>
+        static void normalize(const T *inptr, T *outptr, size_t len,
+                              size_t stride, size_t count, bool isLog)
+        {
+            T max[blockColumns], sum[blockColumns];
+            std::copy_n(inptr, count, max);
+            std::fill_n(sum, count, T(0));
+            for (size_t j = 1; j < len; ++j)
+                for (size_t c = 0; c < count; ++c)
+                    max[c] = std::max(max[c], inptr[j * stride + c]);
+            for (size_t j = 0; j < len; ++j)
+                for (size_t c = 0; c < count; ++c)
+                {
+                    T e = expCompute(inptr[j * stride + c] - max[c]);
+                    sum[c] += e;
+                    if (!isLog)
+                        outptr[j * stride + c] = e;
+                }
+            for (size_t c = 0; c < count; ++c)
+                sum[c] = isLog ? logCompute(sum[c]) : 1 / sum[c];
+            for (size_t j = 0; j < len; ++j)
+                for (size_t c = 0; c < count; ++c)
+                {
+                    size_t offset = j * stride + c;
+                    outptr[offset] = isLog
+                                         ? inptr[offset] - max[c] - sum[c]
+                                         : outptr[offset] * sum[c];
+                }
+        }
+
+        template <typename T>
+        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        {
+            auto op = as<SoftmaxObj>(_op);
+            T *inptr = op->getInputs(0)->getRawDataPtr<T *>();
+            T *outptr = op->getOutput()->getRawDataPtr<T *>();
+            bool isLog = op->getOpType() == OpType::LogSoftmax;
+
+            auto dims = op->getInputs(0)->getDims();
+            int axis = op->getAxis();
+            size_t len = dims[axis], inner = 1;
+            for (size_t i = axis + 1; i < dims.size(); ++i)
+                inner *= dims[i];
+            size_t outer = op->getInputs(0)->size() / (len * inner);
+
+            // a task is a block of the columns of one outer index
+            size_t blocks = (inner + blockColumns - 1) / blockColumns;
+            size_t grain = std::max<size_t>(
+                1, (1 << 14) / (len * std::min(inner, blockColumns)));
+            context->parallelFor(0, outer * blocks, grain,
+                                 [&](size_t begin, size_t end)
+                                 {
+                for (size_t task = begin; task < end; ++task)
+                {
+                    size_t o = task / blocks, c = task % blocks * blockColumns;
+                    size_t offset = o * len * inner + c;
+                    normalize(inptr + offset, outptr + offset, len, inner,
+                              std::min(blockColumns, inner - c), isLog);
+                } });
+        }
+
+        bool isApplicable(const Operator &op) const override
+        {
+            return op->getDType() == DataType::Float32 ||
+                   op->getDType() == DataType::Double;
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            dispatchDType<FloatDTypes>(_op->getDType(), [&](auto dt)
+                                       { doCompute<typename decltype(dt)::t>(_op, context); });
+        }
+    };
+
+    REGISTER_KERNEL(Device::CPU, OpType::Softmax, NativeSoftmax,
+                    "softmaxNaive_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::LogSoftmax, NativeSoftmax,
+                    "logSoftmaxNaive_CPU");
+
+}; // namespace infini
@@ -0,0 +1,189 @@
+#include "operators/softmax.h"
+#include "core/kernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include "transcendental_avx2.h"
+
+namespace infini
+{
+    /**
+     * @brief Softmax and LogSoftmax for hosts with AVX2 and FMA, on Float32
+     * only. Rows along the last axis are vectorized along the row and
+     * reduced with horizontal ops; along other axes up to 64 adjacent rows
+     * are normalized in the lanes of 8 vectors.
+     */
+    class Avx2Softmax : public CpuKernelWithoutConfig
+    {
+        // vectors of columns normalized together when the axis is not the
+        // last dim
+        static constexpr size_t blockVectors = 8;
+
+        AVX2_FMA static void row(const float *inptr, float *outptr, size_t len,
+                                 bool isLog)
+        {
+            size_t i = 0;
+            __m256 vmax =
+                _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+            for (; i + 8 <= len; i += 8)
+                vmax = _mm256_max_ps(vmax, _mm256_loadu_ps(inptr + i));
+            float max = avx2::hmax(vmax);
+            for (; i < len; ++i)
+                max = std::max(max, inptr[i]);
+
+            const __m256 shift = _mm256_set1_ps(max);
+            __m256 vsum = _mm256_setzero_ps();
+            for (i = 0; i + 8 <= len; i += 8)
+            {
+                __m256 e = avx2::exp(
+                    _mm256_sub_ps(_mm256_loadu_ps(inptr + i), shift));
+                vsum = _mm256_add_ps(vsum, e);
+                if (!isLog)
+                    _mm256_storeu_ps(outptr + i, e);
+            }
+            float sum = avx2::hsum(vsum);
+            for (; i < len; ++i)
+            {
+                float e = approx::exp(inptr[i] - max);
+                sum += e;
+                if (!isLog)
+                    outptr[i] = e;
+            }
+
+            if (isLog)
+            {
+                float logSum = approx::log(sum);
+                const __m256 vlogSum = _mm256_set1_ps(logSum);
+                for (i = 0; i + 8 <= len; i += 8)
+                    _mm256_storeu_ps(
+                        outptr + i,
+                        _mm256_sub_ps(
+                            _mm256_sub_ps(_mm256_loadu_ps(inptr + i), shift),
+                            vlogSum));
+                for (; i < len; ++i)
+                    outptr[i] = inptr[i] - max - logSum;
+            }
+            else
+            {
+                float scale = 1.f / sum;
+                const __m256 vscale = _mm256_set1_ps(scale);
+                for (i = 0; i + 8 <= len; i += 8)
+                    _mm256_storeu_ps(outptr + i,
+                                     _mm256_mul_ps(_mm256_loadu_ps(outptr + i),
+                                                   vscale));
+                for (; i < len; ++i)
+                    outptr[i] *= scale;
+            }
+        }
+
+        // the count <= 64 adjacent rows along the axis starting at inptr,
+        // whose len elements are stride apart, in the lanes of 8 vectors so
+        // that whole cache lines are used
+        AVX2_FMA static void columns(const float *inptr, float *outptr,
+                                     size_t len, size_t stride, size_t count,
+                                     bool isLog)
+        {
+            const size_t nVectors = (count + 7) / 8;
+            __m256i mask[blockVectors];
+            __m256 max[blockVectors], sum[blockVectors];
+            for (size_t v = 0; v < nVectors; ++v)
+            {
+                mask[v] = _mm256_cmpgt_epi32(
+                    _mm256_set1_epi32(count - v * 8),
+                    _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+                max[v] = _mm256_maskload_ps(inptr + v * 8, mask[v]);
+                sum[v] = _mm256_setzero_ps();
+            }
+            for (size_t j = 1; j < len; ++j)
+                for (size_t v = 0; v < nVectors; ++v)
+                    max[v] = _mm256_max_ps(
+                        max[v], _mm256_maskload_ps(inptr + j * stride + v * 8,
+                                                   mask[v]));
+            for (size_t j = 0; j < len; ++j)
+                for (size_t v = 0; v < nVectors; ++v)
+                {
+                    size_t offset = j * stride + v * 8;
+                    __m256 x = _mm256_maskload_ps(inptr + offset, mask[v]);
+                    __m256 e = avx2::exp(_mm256_sub_ps(x, max[v]));
+                    sum[v] = _mm256_add_ps(sum[v], e);
+                    if (!isLog)
+                        _mm256_maskstore_ps(outptr + offset, mask[v], e);
+                }
+            // the shift of log softmax, or the scale of softmax
+            for (size_t v = 0; v < nVectors; ++v)
+                sum[v] = isLog ? _mm256_add_ps(max[v], avx2::log(sum[v]))
+                               : _mm256_div_ps(_mm256_set1_ps(1.f), sum[v]);
+            for (size_t j = 0; j < len; ++j)
+                for (size_t v = 0; v < nVectors; ++v)
+                {
+                    size_t offset = j * stride + v * 8;
+                    __m256 y =
+                        isLog ? _mm256_sub_ps(
+                                    _mm256_maskload_ps(inptr + offset, mask[v]),
+                                    sum[v])
+                              : _mm256_mul_ps(
+                                    _mm256_maskload_ps(outptr + offset, mask[v]),
+                                    sum[v]);
+                    _mm256_maskstore_ps(outptr + offset, mask[v], y);
+                }
+        }
+
+        bool isApplicable(const Operator &op) const override
+        {
+            return op->getDType() == DataType::Float32;
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            auto op = as<SoftmaxObj>(_op);
+            auto inptr = op->getInputs(0)->getRawDataPtr<float *>();
+            auto outptr = op->getOutput()->getRawDataPtr<float *>();
+            bool isLog = op->getOpType() == OpType::LogSoftmax;
+
+            auto dims = op->getInputs(0)->getDims();
+            int axis = op->getAxis();
+            size_t len = dims[axis], inner = 1;
+            for (size_t i = axis + 1; i < dims.size(); ++i)
+                inner *= dims[i];
+            size_t outer = op->getInputs(0)->size() / (len * inner);
+
+            if (inner == 1)
+            {
+                context->parallelFor(
+                    0, outer, std::max<size_t>(1, (1 << 14) / len),
+                    [&](size_t begin, size_t end)
+                    {
+                        for (size_t o = begin; o < end; ++o)
+                            row(inptr + o * len, outptr + o * len, len, isLog);
+                    });
+                return;
+            }
+            // a task is a block of the columns of one outer index
+            const size_t blockColumns = blockVectors * 8;
+            size_t blocks = (inner + blockColumns - 1) / blockColumns;
+            size_t grain = std::max<size_t>(
+                1, (1 << 14) / (len * std::min(inner, blockColumns)));
+            context->parallelFor(
+                0, outer * blocks, grain,
+                [&](size_t begin, size_t end)
+                {
+                    for (size_t task = begin; task < end; ++task)
+                    {
+                        size_t o = task / blocks,
+                               c = task % blocks * blockColumns;
+                        size_t offset = o * len * inner + c;
+                        columns(inptr + offset, outptr + offset, len, inner,
+                                std::min(blockColumns, inner - c), isLog);
+                    }
+                });
+        }
+    };
+
+    REGISTER_KERNEL_ISA(Device::CPU, OpType::Softmax, IsaLevel::AVX2,
+                        Avx2Softmax, "softmaxAvx2_CPU");
+    REGISTER_KERNEL_ISA(Device::CPU, OpType::LogSoftmax, IsaLevel::AVX2,
+                        Avx2Softmax, "logSoftmaxAvx2_CPU");
+
+}; // namespace infini
+
+#endif
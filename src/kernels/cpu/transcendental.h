@@ -0,0 +1,168 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+/**
+ * Float32 approximations of the transcendental activations, shared by the
+ * unary kernels so that every ISA variant computes the same functions. The
+ * scalar forms below are used by the generic kernels and for the tails of
+ * the vectorized ones; the constants are also used by the vector forms.
+ *
+ * Measured errors against a double precision reference over the whole
+ * float range, for normal results: exp, log, tanh and sigmoid are within
+ * 3 ULP, silu, erf and gelu within 4 ULP.
+ */
+namespace infini::approx
+{
+    // outside [expLo, expHi] exp overflows to inf or rounds to 0
+    constexpr float expHi = 88.7228394f, expLo = -104.f;
+    constexpr float log2e = 1.44269504088896341f;
+    // ln(2) split in a part exact in few bits and a correction (Cody-Waite)
+    constexpr float ln2Hi = 0.693359375f, ln2Lo = -2.12194440e-4f;
+    // exp(r) = 1 + r + r^2 * P(r) on |r| <= ln(2) / 2
+    constexpr float expP[] = {1.9875691500e-4f, 1.3981999507e-3f,
+                              8.3334519073e-3f, 4.1665795894e-2f,
+                              1.6666665459e-1f, 5.0000001201e-1f};
+    // log(1 + m) = m - m^2 / 2 + m^3 * P(m) on sqrt(1/2) - 1 <= m < sqrt(2) - 1
+    constexpr float sqrtHalf = 0.707106781186547524f;
+    constexpr float logP[] = {7.0376836292e-2f, -1.1514610310e-1f,
+                              1.1676998740e-1f, -1.2420140846e-1f,
+                              1.4249322787e-1f, -1.6668057665e-1f,
+                              2.0000714765e-1f, -2.4999993993e-1f,
+                              3.3333331174e-1f};
+    // tanh(x) = x + x^3 * P(x^2) on |x| < tanhSmall
+    constexpr float tanhSmall = 0.625f;
+    constexpr float tanhP[] = {-5.70498872745e-3f, 2.06390887954e-2f,
+                               -5.37397155531e-2f, 1.33314422036e-1f,
+                               -3.33332819422e-1f};
+    // erf(x) = x * P(x^2) on |x| < 1
+    constexpr float erfP[] = {7.853861353153693e-5f, -8.010193625184903e-4f,
+                              5.188327685732524e-3f, -2.685381193529856e-2f,
+                              1.128358514861418e-1f, -3.761262582423300e-1f,
+                              1.128379165726710e+0f};
+    // erf(x) = 1 - t * P(t) * exp(-x^2) with t = 1 / (1 + p x) on x >= 1,
+    // Abramowitz and Stegun 7.1.26
+    constexpr float erfTailP = 0.3275911f;
+    constexpr float erfTail[] = {1.061405429f, -1.453152027f, 1.421413741f,
+                                 -0.284496736f, 0.254829592f};
+    constexpr float sqrtHalfGelu = 0.707106781186547524f;
+    // 1 + erf(x / sqrt(2)) cancels for x < -geluTail, there gelu(x) is
+    // -u / 2 * erfcx(u / sqrt(2)) * exp(-u^2 / 2) with u = -x and
+    // erfcx(z) = exp(z^2) * erfc(z), which is P(u - geluMid) on u < geluFar
+    // and Q(1 / u^2) / u beyond, fitted for relative error
+    constexpr float geluTail = 0.5f, geluMid = 1.5f, geluFar = 2.5f;
+    constexpr float geluMidP[] = {3.7249176330e-6f, -1.6012063497e-5f,
+                                  5.3718227718e-5f, -2.0150246564e-4f,
+                                  7.3688832344e-4f, -2.5336204562e-3f,
+                                  8.2207648084e-3f, -2.4993797764e-2f,
+                                  7.0373736322e-2f, -1.8054257333e-1f,
+                                  4.1156134009e-1f};
+    constexpr float geluFarQ[] = {5.6075336914e+3f, -4.6285351562e+3f,
+                                  1.7203051758e+3f, -3.9709402466e+2f,
+                                  6.9627708435e+1f, -1.1612112999e+1f,
+                                  2.3888306618e+0f, -7.9785829782e-1f,
+                                  7.9788452387e-1f};
+
+    template <size_t N>
+    inline float horner(const float (&coeffs)[N], float x)
+    {
+        float y = coeffs[0];
+        for (size_t i = 1; i < N; ++i)
+            y = y * x + coeffs[i];
+        return y;
+    }
+
+    // exp(x + xLo), xLo carries the bits of an argument that do not fit x
+    inline float exp(float x, float xLo)
+    {
+        if (!(x >= expLo && x <= expHi))
+            return x > expHi   ? std::numeric_limits<float>::infinity()
+                   : x < expLo ? 0.f
+                               : x; // NaN
+        float n = std::floor(x * log2e + 0.5f);
+        float r = x - n * ln2Hi;
+        r = r - n * ln2Lo + xLo;
+        float y = horner(expP, r) * r * r + r + 1.f;
+        // n is in [-150, 128], 2^n is applied in two normal halves so that
+        // subnormal results are rounded once
+        int32_t k = int32_t(n), k0 = k >> 1;
+        int32_t bits0 = (k0 + 127) << 23, bits1 = (k - k0 + 127) << 23;
+        float s0, s1;
+        std::memcpy(&s0, &bits0, sizeof(float));
+        std::memcpy(&s1, &bits1, sizeof(float));
+        return y * s0 * s1;
+    }
+
+    inline float exp(float x) { return exp(x, 0.f); }
+
+    inline float log(float x)
+    {
+        if (!(x > 0.f && x < std::numeric_limits<float>::infinity()))
+            return x == 0.f  ? -std::numeric_limits<float>::infinity()
+                   : x > 0.f ? x
+                             : std::numeric_limits<float>::quiet_NaN();
+        int e;
+        float m = std::frexp(x, &e);
+        if (m < sqrtHalf)
+        {
+            e -= 1;
+            m = m + m - 1.f;
+        }
+        else
+            m = m - 1.f;
+        float z = m * m;
+        float y = horner(logP, m) * m * z;
+        float fe = float(e);
+        y += fe * ln2Lo;
+        y -= 0.5f * z;
+        return m + y + fe * ln2Hi;
+    }
+
+    // exp(-|x|) cannot overflow, and exp(x) / (1 + exp(x)) keeps the
+    // precision of tiny results for negative x
+    inline float sigmoid(float x)
+    {
+        float e = exp(-std::fabs(x));
+        return (x < 0.f ? e : 1.f) / (1.f + e);
+    }
+
+    inline float silu(float x) { return x * sigmoid(x); }
+
+    inline float tanh(float x)
+    {
+        float a = std::fabs(x);
+        if (a < tanhSmall)
+        {
+            float z = x * x;
+            return horner(tanhP, z) * z * x + x;
+        }
+        // exp overflows to inf for large |x|, giving 1
+        float y = 1.f - 2.f / (exp(a + a) + 1.f);
+        return std::copysign(y, x);
+    }
+
+    inline float erf(float x)
+    {
+        float a = std::fabs(x);
+        if (a < 1.f)
+            return horner(erfP, x * x) * x;
+        float t = 1.f / (1.f + erfTailP * a);
+        float y = 1.f - horner(erfTail, t) * t * exp(-a * a);
+        return std::copysign(y, x);
+    }
+
+    inline float gelu(float x)
+    {
+        if (!(x < -geluTail))
+            return 0.5f * x * (1.f + erf(x * sqrtHalfGelu));
+        // u^2 = h + l exactly, exp(-u^2 / 2) would lose the rounding of h
+        float u = -x, h = u * u, l = std::fma(u, u, -h);
+        float e = exp(-0.5f * h, -0.5f * l);
+        if (u < geluFar)
+            return -0.5f * u * horner(geluMidP, u - geluMid) * e;
+        return -0.5f * horner(geluFarQ, 1.f / h) * e;
+    }
+
+} // namespace infini::approx
@@ -0,0 +1,199 @@
+#pragma once
+#include "transcendental.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+// for the functions of kernels that run on IsaLevel::AVX2 hosts
+#define AVX2_FMA __attribute__((target("avx2,fma")))
+
+namespace infini
+{
+    // The functions of transcendental.h on 8 floats. The clamps take x as
+    // their second operand, which min and max return when it is NaN.
+    namespace avx2
+    {
+        template <size_t N>
+        AVX2_FMA static inline __m256 horner(const float (&coeffs)[N], __m256 x)
+        {
+            __m256 y = _mm256_set1_ps(coeffs[0]);
+            for (size_t i = 1; i < N; ++i)
+                y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(coeffs[i]));
+            return y;
+        }
+
+        AVX2_FMA static inline __m256 abs(__m256 x)
+        {
+            return _mm256_andnot_ps(_mm256_set1_ps(-0.f), x);
+        }
+
+        // |y| with the sign of x
+        AVX2_FMA static inline __m256 copysign(__m256 y, __m256 x)
+        {
+            const __m256 sign = _mm256_set1_ps(-0.f);
+            return _mm256_or_ps(_mm256_andnot_ps(sign, y), _mm256_and_ps(sign, x));
+        }
+
+        // the sum and the maximum of the 8 lanes
+        AVX2_FMA static inline float hsum(__m256 x)
+        {
+            __m128 v = _mm_add_ps(_mm256_castps256_ps128(x),
+                                  _mm256_extractf128_ps(x, 1));
+            v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+            return _mm_cvtss_f32(_mm_add_ss(v, _mm_movehdup_ps(v)));
+        }
+
+        AVX2_FMA static inline float hmax(__m256 x)
+        {
+            __m128 v = _mm_max_ps(_mm256_castps256_ps128(x),
+                                  _mm256_extractf128_ps(x, 1));
+            v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+            return _mm_cvtss_f32(_mm_max_ss(v, _mm_movehdup_ps(v)));
+        }
+
+        AVX2_FMA static inline __m256 exp(__m256 x, __m256 xLo)
+        {
+            using namespace approx;
+            __m256 c = _mm256_max_ps(_mm256_set1_ps(expLo),
+                                     _mm256_min_ps(_mm256_set1_ps(expHi), x));
+            __m256 n = _mm256_floor_ps(_mm256_fmadd_ps(
+                c, _mm256_set1_ps(log2e), _mm256_set1_ps(0.5f)));
+            __m256 r = _mm256_fnmadd_ps(n, _mm256_set1_ps(ln2Hi), c);
+            r = _mm256_add_ps(_mm256_fnmadd_ps(n, _mm256_set1_ps(ln2Lo), r),
+                              xLo);
+            __m256 y = _mm256_fmadd_ps(
+                _mm256_mul_ps(horner(expP, r), r), r,
+                _mm256_add_ps(r, _mm256_set1_ps(1.f)));
+            // 2^n in two normal halves, as in approx::exp
+            __m256i k = _mm256_cvttps_epi32(n), k0 = _mm256_srai_epi32(k, 1);
+            const __m256i bias = _mm256_set1_epi32(127);
+            __m256 s0 = _mm256_castsi256_ps(
+                _mm256_slli_epi32(_mm256_add_epi32(k0, bias), 23));
+            __m256 s1 = _mm256_castsi256_ps(_mm256_slli_epi32(
+                _mm256_add_epi32(_mm256_sub_epi32(k, k0), bias), 23));
+            y = _mm256_mul_ps(_mm256_mul_ps(y, s0), s1);
+            y = _mm256_blendv_ps(
+                y, _mm256_set1_ps(std::numeric_limits<float>::infinity()),
+                _mm256_cmp_ps(x, _mm256_set1_ps(expHi), _CMP_GT_OQ));
+            return _mm256_blendv_ps(
+                y, _mm256_setzero_ps(),
+                _mm256_cmp_ps(x, _mm256_set1_ps(expLo), _CMP_LT_OQ));
+        }
+
+        AVX2_FMA static inline __m256 exp(__m256 x)
+        {
+            return exp(x, _mm256_setzero_ps());
+        }
+
+        AVX2_FMA static inline __m256 log(__m256 x)
+        {
+            using namespace approx;
+            // scale subnormals into the normal range first
+            __m256 tiny = _mm256_cmp_ps(
+                x, _mm256_set1_ps(std::numeric_limits<float>::min()),
+                _CMP_LT_OQ);
+            __m256 v = _mm256_blendv_ps(
+                x, _mm256_mul_ps(x, _mm256_set1_ps(8388608.f)), tiny);
+            __m256 fe = _mm256_and_ps(tiny, _mm256_set1_ps(-23.f));
+            // v = m * 2^e with m in [0.5, 1), as frexp
+            __m256i bits = _mm256_castps_si256(v);
+            fe = _mm256_add_ps(
+                fe, _mm256_cvtepi32_ps(_mm256_sub_epi32(
+                        _mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126))));
+            __m256 m = _mm256_castsi256_ps(_mm256_or_si256(
+                _mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)),
+                _mm256_set1_epi32(0x3f000000)));
+            __m256 below = _mm256_cmp_ps(m, _mm256_set1_ps(sqrtHalf), _CMP_LT_OQ);
+            fe = _mm256_sub_ps(fe, _mm256_and_ps(below, _mm256_set1_ps(1.f)));
+            m = _mm256_sub_ps(_mm256_add_ps(m, _mm256_and_ps(below, m)),
+                              _mm256_set1_ps(1.f));
+            __m256 z = _mm256_mul_ps(m, m);
+            __m256 y = _mm256_mul_ps(_mm256_mul_ps(horner(logP, m), m), z);
+            y = _mm256_fmadd_ps(fe, _mm256_set1_ps(ln2Lo), y);
+            y = _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, y);
+            y = _mm256_fmadd_ps(fe, _mm256_set1_ps(ln2Hi), _mm256_add_ps(m, y));
+            // log(0) = -inf, log(x < 0) = NaN, log(inf) = inf, log(NaN) = NaN
+            const __m256 inf =
+                _mm256_set1_ps(std::numeric_limits<float>::infinity());
+            __m256 zero = _mm256_setzero_ps();
+            y = _mm256_blendv_ps(y, _mm256_sub_ps(zero, inf),
+                                 _mm256_cmp_ps(x, zero, _CMP_EQ_OQ));
+            y = _mm256_blendv_ps(
+                y, _mm256_set1_ps(std::numeric_limits<float>::quiet_NaN()),
+                _mm256_cmp_ps(x, zero, _CMP_LT_OQ));
+            return _mm256_blendv_ps(y, x, _mm256_cmp_ps(x, inf, _CMP_EQ_UQ));
+        }
+
+        AVX2_FMA static inline __m256 sigmoid(__m256 x)
+        {
+            __m256 e = exp(_mm256_sub_ps(_mm256_setzero_ps(), abs(x)));
+            __m256 num = _mm256_blendv_ps(
+                _mm256_set1_ps(1.f), e,
+                _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LT_OQ));
+            return _mm256_div_ps(num, _mm256_add_ps(_mm256_set1_ps(1.f), e));
+        }
+
+        AVX2_FMA static inline __m256 silu(__m256 x)
+        {
+            return _mm256_mul_ps(x, sigmoid(x));
+        }
+
+        AVX2_FMA static inline __m256 tanh(__m256 x)
+        {
+            using namespace approx;
+            __m256 a = abs(x);
+            __m256 z = _mm256_mul_ps(x, x);
+            __m256 small =
+                _mm256_fmadd_ps(_mm256_mul_ps(horner(tanhP, z), z), x, x);
+            const __m256 one = _mm256_set1_ps(1.f);
+            __m256 large = _mm256_sub_ps(
+                one, _mm256_div_ps(_mm256_set1_ps(2.f),
+                                   _mm256_add_ps(exp(_mm256_add_ps(a, a)), one)));
+            return _mm256_blendv_ps(
+                copysign(large, x), small,
+                _mm256_cmp_ps(a, _mm256_set1_ps(tanhSmall), _CMP_LT_OQ));
+        }
+
+        AVX2_FMA static inline __m256 erf(__m256 x)
+        {
+            using namespace approx;
+            __m256 a = abs(x);
+            __m256 small = _mm256_mul_ps(horner(erfP, _mm256_mul_ps(x, x)), x);
+            const __m256 one = _mm256_set1_ps(1.f);
+            __m256 t = _mm256_div_ps(
+                one, _mm256_fmadd_ps(_mm256_set1_ps(erfTailP), a, one));
+            __m256 e = exp(_mm256_mul_ps(_mm256_sub_ps(_mm256_setzero_ps(), a), a));
+            __m256 large = _mm256_fnmadd_ps(
+                _mm256_mul_ps(horner(erfTail, t), t), e, one);
+            return _mm256_blendv_ps(copysign(large, x), small,
+                                    _mm256_cmp_ps(a, one, _CMP_LT_OQ));
+        }
+
+        AVX2_FMA static inline __m256 gelu(__m256 x)
+        {
+            using namespace approx;
+            const __m256 half = _mm256_set1_ps(0.5f);
+            const __m256 mhalf = _mm256_set1_ps(-0.5f);
+            __m256 y = erf(_mm256_mul_ps(x, _mm256_set1_ps(sqrtHalfGelu)));
+            __m256 small = _mm256_mul_ps(_mm256_mul_ps(half, x),
+                                        _mm256_add_ps(_mm256_set1_ps(1.f), y));
+            // the tail of approx::gelu, with u^2 = h + l
+            __m256 u = _mm256_sub_ps(_mm256_setzero_ps(), x);
+            __m256 h = _mm256_mul_ps(u, u), l = _mm256_fmsub_ps(u, u, h);
+            __m256 e = exp(_mm256_mul_ps(mhalf, h), _mm256_mul_ps(mhalf, l));
+            __m256 mid = _mm256_mul_ps(
+                u, horner(geluMidP, _mm256_sub_ps(u, _mm256_set1_ps(geluMid))));
+            __m256 large =
+                horner(geluFarQ, _mm256_div_ps(_mm256_set1_ps(1.f), h));
+            __m256 tail = _mm256_blendv_ps(
+                large, mid,
+                _mm256_cmp_ps(u, _mm256_set1_ps(geluFar), _CMP_LT_OQ));
+            tail = _mm256_mul_ps(_mm256_mul_ps(mhalf, tail), e);
+            return _mm256_blendv_ps(
+                small, tail,
+                _mm256_cmp_ps(x, _mm256_set1_ps(-geluTail), _CMP_LT_OQ));
+        }
+    } // namespace avx2
+} // namespace infini
+
+#endif
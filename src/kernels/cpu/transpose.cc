@@ -25,32 +25,23 @@ class NaiveTranspose : public CpuKernelWithoutConfig {
         size_t inSize = inputs[0]->size();
         auto inPtr = inputs[0]->getRawDataPtr<T *>(),
              outPtr = outputs[0]->getRawDataPtr<T *>();
-        // #pragma omp parallel for
-        for (size_t inIdx = 0; inIdx < inSize; ++inIdx) {
-            auto posInput = idx2Pos(inDim, inIdx);
-            int outIdx = 0;
-            for (size_t j = 0, jEnd = perm.size(); j < jEnd; ++j) {
-                outIdx = outIdx * inDim[perm[j]] + posInput[perm[j]];
+        context->parallelFor(0, inSize, 1 << 12, [&](size_t begin, size_t end) {
+            for (size_t inIdx = begin; inIdx < end; ++inIdx) {
+                auto posInput = idx2Pos(inDim, inIdx);
+                int outIdx = 0;
+                for (size_t j = 0, jEnd = perm.size(); j < jEnd; ++j) {
+                    outIdx = outIdx * inDim[perm[j]] + posInput[perm[j]];
+                }
+                outPtr[outIdx] = inPtr[inIdx];
             }
-            outPtr[outIdx] = inPtr[inIdx];
-        }
+        });
     }
 
     void compute(const Operator &_op,
                  const RuntimeObj *context) const override {
-#define CASE(N)                                                                \
-    case N:                                                                    \
-        doCompute<DT<N>::t>(_op, context)
-
-        int dataTypeIdx = _op->getDType().getIndex();
-        switch (dataTypeIdx) {
-            CASE(1); // DataType::Float32
-            break;
-            CASE(12); // DataType::UInt32
-            break;
-        default:
-            IT_TODO_HALT();
-        }
+        dispatchDType<CopyableDTypes>(_op->getDType(), [&](auto dt) {
+            doCompute<typename decltype(dt)::t>(_op, context);
+        });
     }
 };
 
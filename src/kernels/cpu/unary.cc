@@ -1,5 +1,6 @@
 #include "operators/unary.h"
 #include "core/kernel.h"
+#include "transcendental.h"
 
 namespace infini
 {
@@ -32,29 +33,111 @@ namespace infini
                 IT_TODO_HALT();
             }
 
-            for (size_t offset = 0; offset < n; offset++)
-            {
-                outptr[offset] = _doCompute(inptr[offset]);
-            }
+            context->parallelFor(0, n, 1 << 14, [&](size_t begin, size_t end)
+                                 {
+                for (size_t offset = begin; offset < end; offset++)
+                {
+                    outptr[offset] = _doCompute(inptr[offset]);
+                } });
         }
 
         void compute(const Operator &_op,
                      const RuntimeObj *context) const override
         {
-#define CASE(N) \
-    case N:     \
-        doCompute<DT<N>::t>(_op, context)
+            dispatchDType<NumericDTypes>(_op->getDType(), [&](auto dt)
+                                         { doCompute<typename decltype(dt)::t>(_op, context); });
+        }
+    };
+
+    /**
+     * @brief The transcendental activations. Float32 uses the approximations
+     * shared with the vectorized kernels, Float64 uses libm.
+     */
+    class NativeActivation : public CpuKernelWithoutConfig
+    {
+        static constexpr double sqrtHalf = 0.707106781186547524;
+
+        static float expCompute(float val) { return approx::exp(val); }
+        static double expCompute(double val) { return std::exp(val); }
+        static float logCompute(float val) { return approx::log(val); }
+        static double logCompute(double val) { return std::log(val); }
+        static float sigmoidCompute(float val) { return approx::sigmoid(val); }
+        static double sigmoidCompute(double val)
+        {
+            return 1 / (1 + std::exp(-val));
+        }
+        static float siluCompute(float val) { return approx::silu(val); }
+        static double siluCompute(double val)
+        {
+            return val / (1 + std::exp(-val));
+        }
+        static float tanhCompute(float val) { return approx::tanh(val); }
+        static double tanhCompute(double val) { return std::tanh(val); }
+        static float erfCompute(float val) { return approx::erf(val); }
+        static double erfCompute(double val) { return std::erf(val); }
+        static float geluCompute(float val) { return approx::gelu(val); }
+        static double geluCompute(double val)
+        {
+            // erfc keeps the precision that 1 + erf loses for negative val
+            return 0.5 * val * std::erfc(-val * sqrtHalf);
+        }
+
+        template <typename T>
+        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        {
+            auto op = as<UnaryObj>(_op);
+            T *inptr = op->getInputs(0)->getRawDataPtr<T *>();
+            T *outptr = op->getOutput()->getRawDataPtr<T *>();
+            auto n = op->getOutput()->size();
 
-            int dataTypeIdx = _op->getDType().getIndex();
-            switch (dataTypeIdx)
+            T (*_doCompute)
+            (T val);
+            switch (op->getOpType().underlying())
             {
-                CASE(1); // DataType::Float32
+            case OpType::Exp:
+                _doCompute = expCompute;
                 break;
-                CASE(12); // DataType::UInt32
+            case OpType::Log:
+                _doCompute = logCompute;
+                break;
+            case OpType::Sigmoid:
+                _doCompute = sigmoidCompute;
+                break;
+            case OpType::Silu:
+                _doCompute = siluCompute;
+                break;
+            case OpType::Tanh:
+                _doCompute = tanhCompute;
+                break;
+            case OpType::Erf:
+                _doCompute = erfCompute;
+                break;
+            case OpType::Gelu:
+                _doCompute = geluCompute;
                 break;
             default:
                 IT_TODO_HALT();
             }
+
+            context->parallelFor(0, n, 1 << 12, [&](size_t begin, size_t end)
+                                 {
+                for (size_t offset = begin; offset < end; offset++)
+                {
+                    outptr[offset] = _doCompute(inptr[offset]);
+                } });
+        }
+
+        bool isApplicable(const Operator &op) const override
+        {
+            return op->getDType() == DataType::Float32 ||
+                   op->getDType() == DataType::Double;
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            dispatchDType<FloatDTypes>(_op->getDType(), [&](auto dt)
+                                       { doCompute<typename decltype(dt)::t>(_op, context); });
         }
     };
 
@@ -70,36 +153,37 @@ namespace infini
             auto maxValue = op->getMax();
 
             auto n = op->getOutput()->size();
-            for (size_t offset = 0; offset < n; offset++)
-            {
-                auto val = *inptr++;
-                *outptr++ = (minValue && val < *minValue)   ? *minValue
-                            : (maxValue && val > *maxValue) ? *maxValue
-                                                            : val;
-            }
+            context->parallelFor(0, n, 1 << 14, [&](size_t begin, size_t end)
+                                 {
+                for (size_t offset = begin; offset < end; offset++)
+                {
+                    auto val = inptr[offset];
+                    outptr[offset] = (minValue && val < *minValue)   ? *minValue
+                                     : (maxValue && val > *maxValue) ? *maxValue
+                                                                     : val;
+                } });
         }
 
         void compute(const Operator &_op,
                      const RuntimeObj *context) const override
         {
-#define CASE(N) \
-    case N:     \
-        doCompute<DT<N>::t>(_op, context)
-
-            int dataTypeIdx = _op->getDType().getIndex();
-            switch (dataTypeIdx)
-            {
-                CASE(1); // DataType::Float32
-                break;
-                CASE(12); // DataType::UInt32
-                break;
-            default:
-                IT_TODO_HALT();
-            }
+            dispatchDType<NumericDTypes>(_op->getDType(), [&](auto dt)
+                                         { doCompute<typename decltype(dt)::t>(_op, context); });
         }
     };
 
     REGISTER_KERNEL(Device::CPU, OpType::Relu, NativeUnary, "reluNaive_CPU");
     REGISTER_KERNEL(Device::CPU, OpType::Clip, Clip, "Clip_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::Exp, NativeActivation, "expNaive_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::Log, NativeActivation, "logNaive_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::Sigmoid, NativeActivation,
+                    "sigmoidNaive_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::Silu, NativeActivation,
+                    "siluNaive_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::Tanh, NativeActivation,
+                    "tanhNaive_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::Erf, NativeActivation, "erfNaive_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::Gelu, NativeActivation,
+                    "geluNaive_CPU");
 
 }; // namespace infini
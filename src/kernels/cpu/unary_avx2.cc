@@ -0,0 +1,130 @@
+#include "operators/unary.h"
+#include "core/kernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include "transcendental_avx2.h"
+
+namespace infini
+{
+    /**
+     * @brief Relu for hosts with AVX2. Only Float32 is vectorized, other data
+     * types are left to the generic kernel.
+     */
+    class Avx2Relu : public CpuKernelWithoutConfig
+    {
+        __attribute__((target("avx2"))) static void
+        reluFloat(const float *inptr, float *outptr, size_t n)
+        {
+            const __m256 zero = _mm256_setzero_ps();
+            size_t offset = 0;
+            for (; offset + 8 <= n; offset += 8)
+            {
+                __m256 val = _mm256_loadu_ps(inptr + offset);
+                _mm256_storeu_ps(outptr + offset, _mm256_max_ps(val, zero));
+            }
+            for (; offset < n; offset++)
+                outptr[offset] = std::max(0.f, inptr[offset]);
+        }
+
+        bool isApplicable(const Operator &op) const override
+        {
+            return op->getDType() == DataType::Float32;
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            auto op = as<UnaryObj>(_op);
+            auto inptr = op->getInputs(0)->getRawDataPtr<float *>();
+            auto outptr = op->getOutput()->getRawDataPtr<float *>();
+            context->parallelFor(0, op->getOutput()->size(), 1 << 14,
+                                 [&](size_t begin, size_t end)
+                                 { reluFloat(inptr + begin, outptr + begin,
+                                             end - begin); });
+        }
+    };
+
+    /**
+     * @brief The transcendental activations for hosts with AVX2 and FMA, on
+     * Float32 only. The tails use the scalar forms of the same
+     * approximations.
+     */
+    class Avx2Activation : public CpuKernelWithoutConfig
+    {
+        template <__m256 (*vector)(__m256), float (*scalar)(float)>
+        AVX2_FMA static void apply(const float *inptr, float *outptr, size_t n)
+        {
+            size_t offset = 0;
+            for (; offset + 8 <= n; offset += 8)
+                _mm256_storeu_ps(outptr + offset,
+                                 vector(_mm256_loadu_ps(inptr + offset)));
+            for (; offset < n; offset++)
+                outptr[offset] = scalar(inptr[offset]);
+        }
+
+        bool isApplicable(const Operator &op) const override
+        {
+            return op->getDType() == DataType::Float32;
+        }
+
+        void compute(const Operator &_op,
+                     const RuntimeObj *context) const override
+        {
+            auto op = as<UnaryObj>(_op);
+            auto inptr = op->getInputs(0)->getRawDataPtr<float *>();
+            auto outptr = op->getOutput()->getRawDataPtr<float *>();
+
+            void (*_doCompute)(const float *, float *, size_t);
+            switch (op->getOpType().underlying())
+            {
+            case OpType::Exp:
+                _doCompute = apply<avx2::exp, approx::exp>;
+                break;
+            case OpType::Log:
+                _doCompute = apply<avx2::log, approx::log>;
+                break;
+            case OpType::Sigmoid:
+                _doCompute = apply<avx2::sigmoid, approx::sigmoid>;
+                break;
+            case OpType::Silu:
+                _doCompute = apply<avx2::silu, approx::silu>;
+                break;
+            case OpType::Tanh:
+                _doCompute = apply<avx2::tanh, approx::tanh>;
+                break;
+            case OpType::Erf:
+                _doCompute = apply<avx2::erf, approx::erf>;
+                break;
+            case OpType::Gelu:
+                _doCompute = apply<avx2::gelu, approx::gelu>;
+                break;
+            default:
+                IT_TODO_HALT();
+            }
+            context->parallelFor(0, op->getOutput()->size(), 1 << 12,
+                                 [&](size_t begin, size_t end)
+                                 { _doCompute(inptr + begin, outptr + begin,
+                                              end - begin); });
+        }
+    };
+
+    REGISTER_KERNEL_ISA(Device::CPU, OpType::Relu, IsaLevel::AVX2, Avx2Relu,
+                        "reluAvx2_CPU");
+    REGISTER_KERNEL_ISA(Device::CPU, OpType::Exp, IsaLevel::AVX2,
+                        Avx2Activation, "expAvx2_CPU");
+    REGISTER_KERNEL_ISA(Device::CPU, OpType::Log, IsaLevel::AVX2,
+                        Avx2Activation, "logAvx2_CPU");
+    REGISTER_KERNEL_ISA(Device::CPU, OpType::Sigmoid, IsaLevel::AVX2,
+                        Avx2Activation, "sigmoidAvx2_CPU");
+    REGISTER_KERNEL_ISA(Device::CPU, OpType::Silu, IsaLevel::AVX2,
+                        Avx2Activation, "siluAvx2_CPU");
+    REGISTER_KERNEL_ISA(Device::CPU, OpType::Tanh, IsaLevel::AVX2,
+                        Avx2Activation, "tanhAvx2_CPU");
+    REGISTER_KERNEL_ISA(Device::CPU, OpType::Erf, IsaLevel::AVX2,
+                        Avx2Activation, "erfAvx2_CPU");
+    REGISTER_KERNEL_ISA(Device::CPU, OpType::Gelu, IsaLevel::AVX2,
+                        Avx2Activation, "geluAvx2_CPU");
+
+}; // namespace infini
+
+#endif
@@ -22,7 +22,7 @@ optional<vector<Shape>> ConcatObj::inferShape(const TensorVec &inputs) {
     // REF: https://onnx.ai/onnx/operators/onnx__Concat.html#concat-13
     // =================================== 作业 ===================================
     // 预计算拼接维度的大小
-    IT_ASSERT(dim > 0 && dim < static_cast<int>(rank), "Dimension out of range");
+    IT_ASSERT(dim >= 0 && dim < static_cast<int>(rank), "Dimension out of range");
 
     int concat_size = dims[dim];
     for (size_t i = 1; i < inputs.size(); i++) {
@@ -0,0 +1,93 @@
+#include "operators/normalization.h"
+#include "utils/operator_utils.h"
+
+namespace infini
+{
+    // scale and bias hold the normalized trailing dims of input, optionally
+    // with leading dims of 1
+    static bool checkAffine(const Shape &input, int axis, const Shape &affine)
+    {
+        size_t normalized = input.size() - axis;
+        if (affine.size() < normalized)
+            return false;
+        size_t leading = affine.size() - normalized;
+        for (size_t i = 0; i < affine.size(); ++i)
+            if (i < leading ? affine[i] != 1
+                            : affine[i] != input[axis + i - leading])
+                return false;
+        return true;
+    }
+
+    static TensorVec layerNormInputs(Tensor input, Tensor scale, Tensor bias)
+    {
+        if (bias)
+            return {input, scale, bias};
+        return {input, scale};
+    }
+
+    LayerNormObj::LayerNormObj(GraphObj *graph, Tensor input, Tensor scale,
+                               Tensor bias, Tensor output, int _axis,
+                               float epsilon)
+        : OperatorObj(OpType::LayerNorm, layerNormInputs(input, scale, bias),
+                      {output}),
+          epsilon(epsilon)
+    {
+        axis = get_real_axis(_axis, input->getRank());
+        IT_ASSERT(checkValid(graph));
+    }
+
+    optional<vector<Shape>> LayerNormObj::inferShape(const TensorVec &inputs)
+    {
+        auto dims = inputs[0]->getDims();
+        for (size_t i = 1; i < inputs.size(); ++i)
+            if (!checkAffine(dims, axis, inputs[i]->getDims()))
+                return std::nullopt;
+        return {{dims}};
+    }
+
+    std::string LayerNormObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        os << vecToString(inputs[0]->getDims()) << ",";
+        os << "axis=" << axis << ",";
+        os << "epsilon=" << epsilon << ",";
+        os << "input=";
+        for (auto input : inputs)
+            os << input->getGuid() << ",";
+        os << "output=" << outputs[0]->getGuid() << ")";
+        return os.str();
+    }
+
+    RMSNormObj::RMSNormObj(GraphObj *graph, Tensor input, Tensor scale,
+                           Tensor output, int _axis, float epsilon)
+        : OperatorObj(OpType::RMSNorm, {input, scale}, {output}),
+          epsilon(epsilon)
+    {
+        axis = get_real_axis(_axis, input->getRank());
+        IT_ASSERT(checkValid(graph));
+    }
+
+    optional<vector<Shape>> RMSNormObj::inferShape(const TensorVec &inputs)
+    {
+        auto dims = inputs[0]->getDims();
+        if (!checkAffine(dims, axis, inputs[1]->getDims()))
+            return std::nullopt;
+        return {{dims}};
+    }
+
+    std::string RMSNormObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        os << vecToString(inputs[0]->getDims()) << ",";
+        os << "axis=" << axis << ",";
+        os << "epsilon=" << epsilon << ",";
+        os << "input=" << inputs[0]->getGuid() << ",";
+        os << "scale=" << inputs[1]->getGuid() << ",";
+        os << "output=" << outputs[0]->getGuid() << ")";
+        return os.str();
+    }
+}; // namespace infini
@@ -0,0 +1,61 @@
+#include "operators/reduce.h"
+#include "utils/operator_utils.h"
+#include <algorithm>
+
+namespace infini
+{
+    ReduceObj::ReduceObj(OpType type, GraphObj *graph, Tensor input,
+                         Tensor output, const optional<vector<int>> &_axes,
+                         bool keepDims)
+        : OperatorObj(type, {input}, {output}), keepDims(keepDims)
+    {
+        int rank = input->getRank();
+        if (_axes && !_axes->empty())
+            for (int axis : *_axes)
+                axes.emplace_back(get_real_axis(axis, rank));
+        else
+            for (int axis = 0; axis < rank; ++axis)
+                axes.emplace_back(axis);
+        std::sort(axes.begin(), axes.end());
+        IT_ASSERT(std::adjacent_find(axes.begin(), axes.end()) == axes.end(),
+                  "Repeated reduce axis");
+        IT_ASSERT(checkValid(graph));
+    }
+
+    bool ReduceObj::isReduced(int axis) const
+    {
+        return std::binary_search(axes.begin(), axes.end(), axis);
+    }
+
+    optional<vector<Shape>> ReduceObj::inferShape(const TensorVec &inputs)
+    {
+        auto dims = inputs[0]->getDims();
+        Shape output;
+        for (size_t i = 0; i < dims.size(); ++i)
+            if (!isReduced(i))
+                output.emplace_back(dims[i]);
+            else if (keepDims)
+                output.emplace_back(1);
+        return {{output}};
+    }
+
+    vector<int> ReduceObj::getOpAttrVector() const
+    {
+        vector<int> ret{keepDims};
+        ret.insert(ret.end(), axes.begin(), axes.end());
+        return ret;
+    }
+
+    std::string ReduceObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        os << vecToString(inputs[0]->getDims()) << ",";
+        os << "axes=" << vecToString(axes) << ",";
+        os << "keepDims=" << keepDims << ",";
+        os << "input=" << inputs[0]->getGuid() << ",";
+        os << "output=" << outputs[0]->getGuid() << ")";
+        return os.str();
+    }
+}; // namespace infini
@@ -0,0 +1,34 @@
+#include "operators/softmax.h"
+#include "utils/operator_utils.h"
+
+namespace infini
+{
+    SoftmaxObj::SoftmaxObj(GraphObj *graph, Tensor input, Tensor output,
+                           int axis)
+        : SoftmaxObj(OpType::Softmax, graph, input, output, axis) {}
+
+    SoftmaxObj::SoftmaxObj(OpType type, GraphObj *graph, Tensor input,
+                           Tensor output, int _axis)
+        : OperatorObj(type, {input}, {output})
+    {
+        axis = get_real_axis(_axis, input->getRank());
+        IT_ASSERT(checkValid(graph));
+    }
+
+    optional<vector<Shape>> SoftmaxObj::inferShape(const TensorVec &inputs)
+    {
+        return {{inputs[0]->getDims()}};
+    }
+
+    std::string SoftmaxObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        os << vecToString(inputs[0]->getDims()) << ",";
+        os << "axis=" << axis << ",";
+        os << "input=" << inputs[0]->getGuid() << ",";
+        os << "output=" << outputs[0]->getGuid() << ")";
+        return os.str();
+    }
+}; // namespace infini
@@ -111,7 +111,8 @@ std::string device_to_str(Device device) {
 std::string get_kernel_attrs_str(const KernelAttrs &kernelAttrs) {
     std::string deviceStr = device_to_str(std::get<0>(kernelAttrs));
     std::string opStr = OpType(std::get<1>(kernelAttrs)).toString();
-    return deviceStr + ", " + opStr;
+    std::string isaStr = isaLevelToString(std::get<2>(kernelAttrs));
+    return deviceStr + ", " + opStr + ", " + isaStr;
 }
 
 } // namespace infini
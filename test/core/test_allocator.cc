@@ -1,9 +1,13 @@
 #include "core/graph.h"
 #include "core/kernel.h"
 #include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
 #include "operators/unary.h"
 
 #include "test.h"
+#include <fstream>
+#include <sstream>
 
 namespace infini
 {
@@ -51,6 +55,29 @@ namespace infini
         EXPECT_EQ(offsetC, offsetD);
     }
 
+    TEST(Allocator, testAllocAboveFreeBlock)
+    {
+        Shape shape = Shape{1, 2, 2, 3};
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Tensor a = make_ref<TensorObj>(shape, DataType::Float32, runtime);
+        Tensor b = make_ref<TensorObj>(shape, DataType::Float32, runtime);
+        Tensor c =
+            make_ref<TensorObj>(Shape{2, 2, 2, 3}, DataType::Float32, runtime);
+        Allocator allocator = Allocator(runtime);
+        // allocate a->b
+        size_t offsetA = allocator.alloc(a->getBytes());
+        size_t offsetB = allocator.alloc(b->getBytes());
+        // free a, then allocate c which does not fit in the hole of a
+        allocator.free(offsetA, a->getBytes());
+        size_t offsetC = allocator.alloc(c->getBytes());
+        // expected to be _->b->c
+        EXPECT_EQ(offsetC, offsetB + b->getBytes());
+        // free b, which merges with the hole of a, then allocate c again
+        allocator.free(offsetB, b->getBytes());
+        size_t offsetD = allocator.alloc(c->getBytes());
+        EXPECT_EQ(offsetD, offsetA);
+    }
+
     TEST(Allocator, testGetPtr)
     {
         Shape shape = Shape{1, 2, 2, 3};
@@ -71,4 +98,120 @@ namespace infini
         EXPECT_EQ(ptr1, ptr2);
     }
 
+    TEST(Allocator, testRuntimeAlloc)
+    {
+        auto runtime = NativeCpuRuntimeObj::getInstance();
+        // large buffers are mapped, small ones come from the heap; both are
+        // zeroed by alloc
+        for (size_t size : {size_t(100), size_t(3) << 20})
+        {
+            auto ptr = static_cast<char *>(runtime->alloc(size));
+            ASSERT_NE(ptr, nullptr);
+            EXPECT_EQ(std::count(ptr, ptr + size, 0), (long)size);
+            ptr[size - 1] = 1;
+            runtime->dealloc(ptr);
+            ptr = static_cast<char *>(runtime->allocUninitialized(size));
+            ASSERT_NE(ptr, nullptr);
+            ptr[size - 1] = 1;
+            runtime->dealloc(ptr);
+        }
+    }
+
+    TEST(Allocator, testArenaInputsZeroed)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({512, 1024}, DataType::Float32);
+        auto relu = g->addOp<ReluObj>(x, nullptr);
+        g->dataMalloc();
+        auto ptr = x->getRawDataPtr<float *>();
+        EXPECT_EQ(std::count(ptr, ptr + x->size(), 0.f), (long)x->size());
+        runtime->run(g);
+        EXPECT_EQ(relu->getOutput()->getRawDataPtr<float *>()[x->size() - 1],
+                  0.f);
+    }
+
+    TEST(Allocator, testRuntimeCache)
+    {
+        auto runtime = make_ref<NativeCpuRuntimeObj>();
+        size_t size = size_t(5) << 20;
+        auto ptr = static_cast<char *>(runtime->alloc(size));
+        ptr[0] = 1;
+        runtime->dealloc(ptr);
+        EXPECT_EQ(runtime->getCacheStats().cachedBuffers, 1u);
+
+        // a slightly smaller arena reuses the buffer, zeroed on request
+        auto reused = static_cast<char *>(runtime->alloc(size - 4096));
+        EXPECT_EQ(reused, ptr);
+        EXPECT_EQ(reused[0], 0);
+        EXPECT_EQ(runtime->getCacheStats().hits, 1u);
+        // a much smaller one does not
+        runtime->dealloc(reused);
+        auto small = runtime->allocUninitialized(size_t(2) << 20);
+        EXPECT_NE(small, (void *)ptr);
+        runtime->dealloc(small);
+        EXPECT_EQ(runtime->getCacheStats().cachedBuffers, 2u);
+
+        runtime->setCacheLimit(0);
+        EXPECT_EQ(runtime->getCacheStats().cachedBytes, 0u);
+        runtime->dealloc(runtime->alloc(size));
+        EXPECT_EQ(runtime->getCacheStats().cachedBuffers, 0u);
+    }
+
+    TEST(Allocator, testTimeline)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor a = g->addTensor({4, 4}, DataType::Float32);
+        Tensor b = g->addTensor({4, 4}, DataType::Float32);
+        auto add = g->addOp<AddObj>(a, b, nullptr);
+        // computed in place of the sum
+        auto relu = g->addOp<ReluObj>(add->getOutput(), nullptr);
+        auto mul = g->addOp<MatmulObj>(relu->getOutput(), a, nullptr);
+        g->dataMalloc();
+
+        using Event = Allocator::Event;
+        // inputs, the sum, its reuse by relu, the product and relu's free
+        vector<std::tuple<Event::Kind, int, UidBaseType>> expected{
+            {Event::Alloc, -1, a->getGuid()},
+            {Event::Alloc, -1, b->getGuid()},
+            {Event::Alloc, 0, add->getOutput()->getGuid()},
+            {Event::Reuse, 1, relu->getOutput()->getGuid()},
+            {Event::Alloc, 2, mul->getOutput()->getGuid()},
+            {Event::Free, 2, relu->getOutput()->getGuid()},
+        };
+        string csvPath = ::testing::TempDir() + "timeline.csv";
+        g->saveMemoryTimeline(csvPath);
+        std::ifstream csv(csvPath);
+        string line;
+        std::getline(csv, line);
+        EXPECT_EQ(line, "event,step,op,tensor,offset,size,used,top");
+        for (auto [kind, step, tensor] : expected)
+        {
+            std::getline(csv, line);
+            const char *names[] = {"alloc", "free", "reuse"};
+            EXPECT_EQ(line.substr(0, line.find(',', line.find(',') + 1)),
+                      string(names[kind]) + "," + std::to_string(step));
+        }
+        auto &timeline = g->getMemoryTimeline();
+        ASSERT_EQ(timeline.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            EXPECT_EQ(timeline[i].kind, std::get<0>(expected[i]));
+            EXPECT_EQ(timeline[i].tensor, std::get<2>(expected[i]));
+        }
+        // the product is allocated above the sum, at the high-water mark
+        EXPECT_EQ(timeline[4].top, g->getArenaBytes());
+        EXPECT_EQ(timeline.back().used, 3 * 64u);
+
+        string jsonPath = ::testing::TempDir() + "timeline.json";
+        g->saveMemoryTimeline(jsonPath);
+        std::stringstream json;
+        json << std::ifstream(jsonPath).rdbuf();
+        EXPECT_NE(json.str().find("\"peak\": {\"step\": 2"), string::npos);
+        EXPECT_NE(json.str().find("{\"tensor\": " +
+                                  std::to_string(mul->getOutput()->getGuid())),
+                  string::npos);
+    }
+
 } // namespace infini
@@ -0,0 +1,66 @@
+#include "core/batching.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    // y = Relu(x * w) with x of shape [batch, 4] and w shared by the buckets
+    static BatchBucket buildBucket(int batch, vector<float> &weight)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({batch, 4}, DataType::Float32);
+        Tensor w = g->addTensor({4, 2}, DataType::Float32);
+        w->setDataBlob(make_ref<BlobObj>(runtime, weight.data()));
+        auto matmul = g->addOp<MatmulObj>(x, w, nullptr);
+        auto relu = g->addOp<ReluObj>(matmul->getOutput(), nullptr);
+        return {g, {x}, {relu->getOutput()}};
+    }
+
+    static vector<char> toBytes(const vector<float> &values)
+    {
+        auto ptr = reinterpret_cast<const char *>(values.data());
+        return vector<char>(ptr, ptr + values.size() * sizeof(float));
+    }
+
+    static vector<float> toFloats(const vector<char> &bytes)
+    {
+        vector<float> values(bytes.size() / sizeof(float));
+        std::memcpy(values.data(), bytes.data(), bytes.size());
+        return values;
+    }
+
+    TEST(Batching, MergesRequests)
+    {
+        // columns: sum of x and negated x[0]
+        vector<float> weight{1, -1, 1, 0, 1, 0, 1, 0};
+        BatchingOptions options;
+        options.buckets = {1, 2, 4};
+        options.timeout = std::chrono::milliseconds(50);
+        DynamicBatcher batcher(
+            [&](int batch) { return buildBucket(batch, weight); }, options);
+
+        vector<std::future<SampleData>> results;
+        for (int i = 0; i < 7; ++i)
+        {
+            float v = i;
+            results.emplace_back(batcher.submit(
+                {toBytes({v, v + 1, v + 2, i % 2 ? -v * 10 : 0})}));
+        }
+        for (int i = 0; i < 7; ++i)
+        {
+            float v = i;
+            float sum = v + v + 1 + v + 2 + (i % 2 ? -v * 10 : 0);
+            auto outputs = results[i].get();
+            ASSERT_EQ(outputs.size(), 1u);
+            EXPECT_EQ(toFloats(outputs[0]),
+                      (vector<float>{std::max(sum, 0.f), 0}));
+        }
+        // 4 + 3 requests, the second batch runs in the bucket of 4
+        EXPECT_LE(batcher.getBatchCount(), 3u);
+        EXPECT_THROW(batcher.submit({toBytes({1, 2})}), Exception);
+    }
+} // namespace infini
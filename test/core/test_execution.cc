@@ -0,0 +1,76 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+
+#include "test.h"
+#include <atomic>
+#include <thread>
+
+namespace infini
+{
+    TEST(Execution, ConcurrentContexts)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({4, 8}, DataType::Float32);
+        Tensor w = g->addTensor({8, 8}, DataType::Float32);
+        // the weight is bound before dataMalloc so that contexts share it
+        vector<float> weight(64);
+        for (int i = 0; i < 8; ++i)
+            weight[i * 8 + i] = 2;
+        w->setDataBlob(make_ref<BlobObj>(runtime, weight.data()));
+        auto matmul = g->addOp<MatmulObj>(x, w, nullptr);
+        auto add = g->addOp<AddObj>(matmul->getOutput(), x, nullptr);
+        Tensor y = add->getOutput();
+        g->dataMalloc();
+
+        // y = 3 * x
+        constexpr int nThreads = 4, nRuns = 20;
+        std::vector<std::thread> threads;
+        std::atomic<int> failures{0};
+        for (int t = 0; t < nThreads; ++t)
+            threads.emplace_back([&, t] {
+                for (int r = 0; r < nRuns; ++r)
+                {
+                    auto context = g->acquireContext();
+                    ExecutionScope scope(context);
+                    float value = t * 100 + r;
+                    x->setData([value](void *ptr, size_t size, DataType) {
+                        for (size_t i = 0; i < size; ++i)
+                            static_cast<float *>(ptr)[i] = value + i;
+                    });
+                    runtime->run(g);
+                    vector<float> expected(32);
+                    for (size_t i = 0; i < expected.size(); ++i)
+                        expected[i] = 3 * (value + i);
+                    if (!y->equalData(expected))
+                        ++failures;
+                }
+            });
+        for (auto &thread : threads)
+            thread.join();
+        EXPECT_EQ(failures, 0);
+
+        // arena tensors resolve into the current context, weights do not
+        char *firstBase;
+        {
+            auto first = g->acquireContext();
+            auto second = g->acquireContext();
+            firstBase = first->getBase();
+            EXPECT_NE(firstBase, second->getBase());
+            char *graphPtr = y->getRawDataPtr<char *>();
+            ExecutionScope scope(first);
+            char *contextPtr = y->getRawDataPtr<char *>();
+            EXPECT_NE(contextPtr, graphPtr);
+            EXPECT_GE(contextPtr, firstBase);
+            EXPECT_LT(contextPtr, firstBase + first->getBytes());
+            EXPECT_EQ(w->getRawDataPtr<float *>(), weight.data());
+        }
+        // released contexts are reused
+        auto reused = g->acquireContext();
+        auto reusedAgain = g->acquireContext();
+        EXPECT_TRUE(reused->getBase() == firstBase ||
+                    reusedAgain->getBase() == firstBase);
+    }
+} // namespace infini
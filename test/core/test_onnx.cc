@@ -0,0 +1,163 @@
+#include "core/onnx.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+
+#include "test.h"
+#include <cstring>
+#include <fstream>
+
+namespace infini
+{
+    // A minimal protobuf encoder for building ONNX models in tests.
+    class ProtoWriter
+    {
+        string buffer;
+
+        void varint(uint64_t value)
+        {
+            for (; value >= 0x80; value >>= 7)
+                buffer += char(value | 0x80);
+            buffer += char(value);
+        }
+
+    public:
+        ProtoWriter &integer(uint32_t field, int64_t value)
+        {
+            varint(field << 3);
+            varint(value);
+            return *this;
+        }
+        ProtoWriter &fixed32(uint32_t field, float value)
+        {
+            varint(field << 3 | 5);
+            buffer.append(reinterpret_cast<const char *>(&value), 4);
+            return *this;
+        }
+        ProtoWriter &bytes(uint32_t field, const string &value)
+        {
+            varint(field << 3 | 2);
+            varint(value.size());
+            buffer += value;
+            return *this;
+        }
+        ProtoWriter &message(uint32_t field, const ProtoWriter &value)
+        {
+            return bytes(field, value.str());
+        }
+        const string &str() const { return buffer; }
+    };
+
+    static ProtoWriter valueInfo(const string &name, vector<string> dims)
+    {
+        ProtoWriter shape;
+        for (auto &dim : dims)
+        {
+            if (isdigit(dim[0]))
+                shape.message(1, ProtoWriter().integer(1, std::stoi(dim)));
+            else
+                shape.message(1, ProtoWriter().bytes(2, dim));
+        }
+        auto tensorType = ProtoWriter().integer(1, 1).message(2, shape);
+        return ProtoWriter().bytes(1, name).message(
+            2, ProtoWriter().message(1, tensorType));
+    }
+
+    static string floatBytes(const vector<float> &values)
+    {
+        return string(reinterpret_cast<const char *>(values.data()),
+                      values.size() * sizeof(float));
+    }
+
+    static void writeFile(const string &path, const string &content)
+    {
+        std::ofstream(path, std::ios::binary) << content;
+    }
+
+    // y = Relu(Gemm(x, w, b, transB = 1)) with x of shape [N, 3]
+    static string gemmReluModel(const ProtoWriter &weight)
+    {
+        vector<float> bias{-100, 0, 100, -1};
+        string packedBias;
+        for (auto value : bias)
+            packedBias += floatBytes({value});
+        auto b = ProtoWriter()
+                     .integer(1, 4)
+                     .integer(2, 1)
+                     .bytes(4, packedBias)
+                     .bytes(8, "b");
+        auto gemm = ProtoWriter()
+                        .bytes(1, "x")
+                        .bytes(1, "w")
+                        .bytes(1, "b")
+                        .bytes(2, "t")
+                        .bytes(4, "Gemm")
+                        .message(5, ProtoWriter().bytes(1, "transB").integer(3, 1))
+                        .message(5, ProtoWriter().bytes(1, "alpha").fixed32(2, 1));
+        auto relu = ProtoWriter().bytes(1, "t").bytes(2, "y").bytes(4, "Relu");
+        auto graph = ProtoWriter()
+                         .message(1, gemm)
+                         .message(1, relu)
+                         .bytes(2, "gemm_relu")
+                         .message(5, weight)
+                         .message(5, b)
+                         .message(11, valueInfo("x", {"N", "3"}))
+                         .message(12, valueInfo("y", {"N", "4"}));
+        return ProtoWriter().integer(1, 8).message(7, graph).str();
+    }
+
+    static void checkGemmRelu(const OnnxModel &model)
+    {
+        ASSERT_EQ(model.inputs.size(), 1u);
+        ASSERT_EQ(model.outputs.size(), 1u);
+        auto x = model.getInput("x"), y = model.getOutput("y");
+        EXPECT_EQ(x->getDims(), (Shape{2, 3}));
+        EXPECT_EQ(y->getDims(), (Shape{2, 4}));
+        auto matmul = as<MatmulObj>(model.graph->getOperators()[0]);
+        ASSERT_TRUE(matmul);
+        EXPECT_TRUE(matmul->getTransB());
+
+        model.graph->dataMalloc();
+        x->setData(IncrementalGenerator());
+        model.graph->getRuntime()->run(model.graph);
+        // x * w^T = [[0, 1, 2, 3], [3, 4, 5, 12]]
+        EXPECT_TRUE(y->equalData(vector<float>{0, 1, 102, 2, 0, 4, 105, 11}));
+    }
+
+    TEST(Onnx, GemmRelu)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        string path = ::testing::TempDir() + "gemm_relu.onnx";
+        auto w = ProtoWriter()
+                     .integer(1, 4)
+                     .integer(1, 3)
+                     .integer(2, 1)
+                     .bytes(8, "w")
+                     .bytes(9, floatBytes({1, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 1}));
+        writeFile(path, gemmReluModel(w));
+        checkGemmRelu(loadOnnx(runtime, path, {{"N", 2}}));
+        EXPECT_THROW(loadOnnx(runtime, path), Exception);
+    }
+
+    TEST(Onnx, ExternalData)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        string path = ::testing::TempDir() + "gemm_relu_external.onnx";
+        writeFile(::testing::TempDir() + "gemm_relu.weights",
+                  "pad!" +
+                      floatBytes({1, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 1}));
+        auto entry = [](const string &key, const string &value) {
+            return ProtoWriter().bytes(1, key).bytes(2, value);
+        };
+        auto w = ProtoWriter()
+                     .integer(1, 4)
+                     .integer(1, 3)
+                     .integer(2, 1)
+                     .bytes(8, "w")
+                     .message(13, entry("location", "gemm_relu.weights"))
+                     .message(13, entry("offset", "4"))
+                     .message(13, entry("length", "48"))
+                     .integer(14, 1);
+        writeFile(path, gemmReluModel(w));
+        checkGemmRelu(loadOnnx(runtime, path, {{"N", 2}}));
+    }
+} // namespace infini
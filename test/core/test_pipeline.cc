@@ -0,0 +1,84 @@
+#include "core/pipeline.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(Pipeline, Partition)
+    {
+        EXPECT_EQ(PipelineExecutor::partition({1, 1, 1, 1}, 2),
+                  (vector<size_t>{0, 2}));
+        EXPECT_EQ(PipelineExecutor::partition({5, 1, 1, 1, 1, 1}, 2),
+                  (vector<size_t>{0, 1}));
+        EXPECT_EQ(PipelineExecutor::partition({1, 2, 3, 4, 5}, 3),
+                  (vector<size_t>{0, 3, 4}));
+        // never more stages than ops
+        EXPECT_EQ(PipelineExecutor::partition({1, 1}, 4),
+                  (vector<size_t>{0, 1}));
+    }
+
+    TEST(Pipeline, MicroBatches)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({2, 8}, DataType::Float32);
+        Tensor one = g->addTensor({1}, DataType::Float32);
+        vector<float> oneData{1};
+        one->setDataBlob(make_ref<BlobObj>(runtime, oneData.data()));
+        // y = relu(relu(x + 1) * (x + 1) - 1) + 1
+        Tensor t = g->addOp<AddObj>(x, one, nullptr)->getOutput();
+        Tensor r = g->addOp<ReluObj>(t, nullptr)->getOutput();
+        Tensor m = g->addOp<MulObj>(r, t, nullptr)->getOutput();
+        Tensor s = g->addOp<SubObj>(m, one, nullptr)->getOutput();
+        Tensor r2 = g->addOp<ReluObj>(s, nullptr)->getOutput();
+        Tensor y = g->addOp<AddObj>(r2, one, nullptr)->getOutput();
+        g->dataMalloc();
+
+        auto bytes = [](const vector<float> &values) {
+            auto ptr = reinterpret_cast<const char *>(values.data());
+            return vector<char>(ptr, ptr + values.size() * sizeof(float));
+        };
+        auto expected = [](float v) {
+            float t = v + 1, r = std::max(t, 0.f);
+            return std::max(r * t - 1, 0.f) + 1;
+        };
+
+        PipelineOptions options;
+        options.nStages = 3;
+        PipelineExecutor pipeline(g, {y}, options);
+        EXPECT_EQ(pipeline.getStages().size(), 3u);
+        vector<std::future<vector<vector<char>>>> results;
+        for (int i = 0; i < 16; ++i)
+        {
+            vector<float> input(16);
+            for (int j = 0; j < 16; ++j)
+                input[j] = i - j;
+            results.emplace_back(pipeline.submit({{x, bytes(input)}}));
+        }
+        for (int i = 0; i < 16; ++i)
+        {
+            vector<float> output(16);
+            for (int j = 0; j < 16; ++j)
+                output[j] = expected(i - j);
+            EXPECT_EQ(results[i].get()[0], bytes(output));
+        }
+    }
+
+    TEST(Pipeline, BadCores)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({4}, DataType::Float32);
+        Tensor r = g->addOp<ReluObj>(x, nullptr)->getOutput();
+        Tensor y = g->addOp<ReluObj>(r, nullptr)->getOutput();
+        g->dataMalloc();
+
+        // the second core set is rejected before any stage thread starts
+        PipelineOptions options;
+        options.stageCpus = {getAllowedCpus(), {-1}};
+        EXPECT_THROW(PipelineExecutor(g, {y}, options), Exception);
+    }
+} // namespace infini
@@ -0,0 +1,116 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+
+#include "test.h"
+#include <fstream>
+#include <sstream>
+
+namespace infini
+{
+    static Graph buildGraph(Runtime runtime, TensorVec &io)
+    {
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor a = g->addTensor({2, 3, 4}, DataType::Float32);
+        Tensor b = g->addTensor({2, 5, 4}, DataType::Float32);
+        Tensor bt = g->addTensor({2, 4, 5}, DataType::Float32);
+        Tensor c = g->addTensor({2, 3, 5}, DataType::Float32);
+        g->addOpWithOutputs<TransposeObj>(b, bt, Shape{0, 2, 1});
+        g->addOpWithOutputs<MatmulObj>(a, bt, c);
+        auto clip = g->addOp<ClipObj>(c, nullptr, 0.5f, 100.0f);
+        io = {a, b, clip->getOutput()};
+        return g;
+    }
+
+    TEST(Plan, SaveAndApply)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        string path = ::testing::TempDir() + "graph.plan";
+        std::remove(path.c_str());
+
+        TensorVec io;
+        Graph g = buildGraph(runtime, io);
+        EXPECT_FALSE(g->compile(path));
+        // the transpose is merged into the matmul by optimize
+        EXPECT_EQ(g->getOperators().size(), 2u);
+        io[0]->setData(IncrementalGenerator());
+        io[1]->setData(IncrementalGenerator());
+        runtime->run(g);
+
+        TensorVec planIo;
+        Graph planned = buildGraph(runtime, planIo);
+        EXPECT_TRUE(planned->compile(path));
+        ASSERT_EQ(planned->getOperators().size(), 2u);
+        auto matmul = as<MatmulObj>(planned->getOperators()[0]);
+        ASSERT_TRUE(matmul);
+        EXPECT_TRUE(matmul->getTransB());
+        EXPECT_EQ(matmul->getInputs(1), planIo[1]);
+        auto clip = as<ClipObj>(planned->getOperators()[1]);
+        ASSERT_TRUE(clip);
+        EXPECT_EQ(clip->getMin(), std::optional<float>(0.5f));
+        // the plan keeps the arena layout
+        for (size_t i = 1; i < io.size(); ++i)
+            EXPECT_EQ(planIo[i]->getRawDataPtr<char *>() -
+                          planIo[0]->getRawDataPtr<char *>(),
+                      io[i]->getRawDataPtr<char *>() -
+                          io[0]->getRawDataPtr<char *>());
+        planIo[0]->setData(IncrementalGenerator());
+        planIo[1]->setData(IncrementalGenerator());
+        runtime->run(planned);
+        EXPECT_TRUE(planIo[2]->equalData(io[2]));
+
+        // a plan of another graph is rejected and overwritten
+        Graph other = make_ref<GraphObj>(runtime);
+        Tensor x = other->addTensor({4}, DataType::Float32);
+        auto relu = other->addOp<ReluObj>(x, nullptr);
+        EXPECT_FALSE(other->compile(path));
+        EXPECT_EQ(other->getOperators().size(), 1u);
+        EXPECT_TRUE(relu->getOutput()->hasData());
+    }
+
+    class UnusedKernel : public Kernel
+    {
+        void compute(const Operator &, const RuntimeObj *) const override {}
+    };
+
+    TEST(Plan, RejectOtherKernels)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        string path = ::testing::TempDir() + "kernels.plan";
+        std::remove(path.c_str());
+        TensorVec io;
+        EXPECT_FALSE(buildGraph(runtime, io)->compile(path));
+        EXPECT_TRUE(buildGraph(runtime, io)->compile(path));
+
+        // a build with another kernel set may select and place differently
+        KernelRegistry::getInstance().registerKernel(
+            KernelAttrs{Device::CPU, OpType::Unknown, IsaLevel::Generic},
+            new UnusedKernel(), "unusedTest_CPU");
+        EXPECT_FALSE(buildGraph(runtime, io)->compile(path));
+    }
+
+    TEST(Plan, RejectOutOfArena)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        string path = ::testing::TempDir() + "arena.plan";
+        std::remove(path.c_str());
+        TensorVec io;
+        EXPECT_FALSE(buildGraph(runtime, io)->compile(path));
+
+        // shrink the arena below the placed tensors, keeping the key
+        std::ifstream in(path);
+        std::stringstream plan;
+        plan << in.rdbuf();
+        in.close();
+        string text = plan.str();
+        auto pos = text.find("\narena ");
+        ASSERT_NE(pos, string::npos);
+        pos += 7;
+        text.replace(pos, text.find('\n', pos) - pos, "8");
+        std::ofstream(path) << text;
+        EXPECT_THROW(buildGraph(runtime, io)->compile(path), Exception);
+    }
+}
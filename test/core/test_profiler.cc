@@ -0,0 +1,94 @@
+#include "core/graph.h"
+#include "core/profiler.h"
+#include "core/runtime.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(Profiler, PerOpEntries)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor a = g->addTensor({2, 3}, DataType::Float32);
+        Tensor b = g->addTensor({3, 4}, DataType::Float32);
+        auto matmul = g->addOp<MatmulObj>(a, b, nullptr);
+        auto relu0 = g->addOp<ReluObj>(matmul->getOutput(), nullptr);
+        g->addOp<ReluObj>(relu0->getOutput(), nullptr);
+        g->dataMalloc();
+
+        auto profiler = make_ref<Profiler>();
+        runtime->setProfiler(profiler);
+        runtime->run(g);
+        runtime->run(g);
+        runtime->setProfiler(nullptr);
+        runtime->run(g);
+
+        auto entries = profiler->getEntries();
+        ASSERT_EQ(entries.size(), 2u);
+        for (auto &entry : entries)
+        {
+            if (entry.opType == "MatMul")
+            {
+                EXPECT_EQ(entry.calls, 2u);
+                EXPECT_EQ(entry.bytes, 2 * (6 + 12 + 8) * sizeof(float));
+                EXPECT_EQ(entry.flops, 2 * 2 * 2 * 4 * 3);
+                if (profiler->hasCounter(Profiler::Instructions))
+                {
+                    EXPECT_GT(entry.counters[Profiler::Instructions], 0u);
+                }
+            }
+            else
+            {
+                EXPECT_EQ(entry.opType, "Relu");
+                EXPECT_EQ(entry.calls, 4u);
+                EXPECT_EQ(entry.bytes, 4 * 2 * 8 * sizeof(float));
+            }
+            EXPECT_GT(entry.ms, 0);
+        }
+        EXPECT_NE(profiler->report().find("Relu"), string::npos);
+        auto peak = probeMachinePeak(runtime.get());
+        EXPECT_GT(peak.gbps, 0);
+        EXPECT_GT(peak.gflops, 0);
+        EXPECT_NE(profiler->roofline(peak).find("MatMul"), string::npos);
+        profiler->clear();
+        EXPECT_TRUE(profiler->getEntries().empty());
+    }
+
+    TEST(Profiler, OpCosts)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor a = g->addTensor({5, 2, 3}, DataType::Float32);
+        Tensor b = g->addTensor({3, 4}, DataType::Float32);
+        Tensor c = g->addTensor({1, 4}, DataType::Float32);
+        auto matmul = g->addOp<MatmulObj>(a, b, nullptr);
+        EXPECT_EQ(matmul->getFlops(), 2 * 5 * 2 * 4 * 3);
+        // broadcasting reads the smaller input once
+        auto add = g->addOp<AddObj>(matmul->getOutput(), c, nullptr);
+        EXPECT_EQ(add->getFlops(), 40);
+        EXPECT_EQ(add->getMinBytes(), (40 + 4 + 40) * sizeof(float));
+        // an input used twice is read once
+        auto mul = g->addOp<MulObj>(c, c, nullptr);
+        EXPECT_EQ(mul->getMinBytes(), 8 * sizeof(float));
+        auto transpose = g->addOp<TransposeObj>(a, nullptr, vector<int>{0, 2, 1});
+        EXPECT_EQ(transpose->getFlops(), 0);
+        EXPECT_EQ(transpose->getMinBytes(), 2 * 30 * sizeof(float));
+        auto concat = g->addOp<ConcatObj>(TensorVec{a, a}, nullptr, 0);
+        EXPECT_EQ(concat->getMinBytes(), (30 + 60) * sizeof(float));
+        auto clip = g->addOp<ClipObj>(a, nullptr, 0.f, std::nullopt);
+        EXPECT_EQ(clip->getFlops(), 30);
+        // transcendental activations count their polynomial evaluations
+        auto relu = g->addOp<ReluObj>(a, nullptr);
+        EXPECT_EQ(relu->getFlops(), 30);
+        auto exp = g->addOp<ExpObj>(a, nullptr);
+        EXPECT_EQ(exp->getFlops(), 24 * 30);
+        auto gelu = g->addOp<GeluObj>(a, nullptr);
+        EXPECT_GT(gelu->getFlops(), exp->getFlops());
+    }
+} // namespace infini
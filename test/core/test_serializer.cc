@@ -0,0 +1,126 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "core/serializer.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+
+#include "test.h"
+#include <cstring>
+#include <fstream>
+
+namespace infini
+{
+    TEST(Serializer, SaveAndLoad)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({2, 3}, DataType::Float32);
+        Tensor w = g->addTensor({4, 3}, DataType::Float32);
+        auto matmul = g->addOp<MatmulObj>(x, w, nullptr, false, true);
+        auto clip = g->addOp<ClipObj>(matmul->getOutput(), nullptr, 10.0f,
+                                      std::nullopt);
+        g->dataMalloc();
+        x->setData(IncrementalGenerator());
+        w->setData(IncrementalGenerator());
+        runtime->run(g);
+
+        string path = ::testing::TempDir() + "graph.itg";
+        saveGraph(g, path, {w});
+        Graph loaded = loadGraph(runtime, path);
+
+        ASSERT_EQ(loaded->getOperators().size(), 2u);
+        auto loadedMatmul = as<MatmulObj>(loaded->getOperators()[0]);
+        auto loadedClip = as<ClipObj>(loaded->getOperators()[1]);
+        ASSERT_TRUE(loadedMatmul && loadedClip);
+        EXPECT_FALSE(loadedMatmul->getTransA());
+        EXPECT_TRUE(loadedMatmul->getTransB());
+        EXPECT_EQ(loadedClip->getMin(), std::optional<float>(10.0f));
+        EXPECT_FALSE(loadedClip->getMax().has_value());
+
+        // the weight is bound to the mapped file before dataMalloc
+        Tensor loadedW = loadedMatmul->getInputs(1);
+        ASSERT_TRUE(loadedW->hasData());
+        auto wPtr = loadedW->getRawDataPtr<float *>();
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(wPtr) % graphFileAlignment, 0u);
+        EXPECT_TRUE(loadedW->equalData(w));
+
+        loaded->dataMalloc();
+        EXPECT_EQ(loadedW->getRawDataPtr<float *>(), wPtr);
+        loadedMatmul->getInputs(0)->setData(IncrementalGenerator());
+        runtime->run(loaded);
+        EXPECT_TRUE(loadedClip->getOutput()->equalData(clip->getOutput()));
+
+        // misaligned payloads are rejected, the payload offset follows the
+        // metadata size in the header and w's record follows x's 33 bytes;
+        // padding keeps the moved payload within the file
+        string original;
+        {
+            std::ifstream file(path, std::ios::binary);
+            original.assign(std::istreambuf_iterator<char>(file), {});
+        }
+        auto misalign = [&](size_t field) {
+            string corrupted = original;
+            uint64_t value;
+            std::memcpy(&value, &corrupted[field], sizeof(value));
+            value += 4;
+            std::memcpy(&corrupted[field], &value, sizeof(value));
+            corrupted += string(graphFileAlignment, '\0');
+            std::ofstream(path, std::ios::binary) << corrupted;
+            EXPECT_THROW(loadGraph(runtime, path), Exception) << field;
+        };
+        misalign(24);
+        misalign(32 + 8 + 33 + 4 + 4 + 8 + 1);
+    }
+
+    TEST(Serializer, RejectCorruptedFile)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({2, 3}, DataType::Float32);
+        g->addOp<ReluObj>(x, nullptr);
+        string path = ::testing::TempDir() + "corrupted.itg";
+        saveGraph(g, path);
+        string original;
+        {
+            std::ifstream file(path, std::ios::binary);
+            original.assign(std::istreambuf_iterator<char>(file), {});
+        }
+        // a graph without weights loads
+        EXPECT_EQ(loadGraph(runtime, path)->getOperators().size(), 1u);
+
+        // The metadata follows the 32-byte header: the tensor count, then
+        // two tensor records of 33 bytes (dtype, rank, 2 dims, payload flag,
+        // offset and size), then the op count and the Relu's type.
+        auto expectRejected = [&](size_t offset, const string &bytes) {
+            string corrupted = original;
+            corrupted.replace(offset, bytes.size(), bytes);
+            std::ofstream(path, std::ios::binary) << corrupted;
+            try
+            {
+                loadGraph(runtime, path);
+                ADD_FAILURE() << "accepted a corruption at " << offset;
+                return;
+            }
+            catch (const Exception &e)
+            {
+                // Exception::what only holds text appended with <<
+                string message = e.std::runtime_error::what();
+                EXPECT_NE(message.find("at offset"), string::npos) << message;
+            }
+        };
+        auto int32Bytes = [](int32_t value) {
+            return string(reinterpret_cast<const char *>(&value), 4);
+        };
+        // a huge tensor count
+        expectRejected(32, string(8, '\xff'));
+        // data types out of range and String
+        expectRejected(40, int32Bytes(99));
+        expectRejected(40, int32Bytes(-1));
+        expectRejected(40, int32Bytes(DataType::String.getIndex()));
+        // a rank beyond the metadata and a negative dim
+        expectRejected(44, int32Bytes(1 << 30));
+        expectRejected(48, int32Bytes(-2));
+        // an unknown operator type
+        expectRejected(114, string(2, '\xff'));
+    }
+}
@@ -0,0 +1,182 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "core/thread_pool.h"
+#include "operators/element_wise.h"
+#include "operators/unary.h"
+
+#include "test.h"
+#include <atomic>
+#include <set>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace infini
+{
+    TEST(ThreadPool, Backpressure)
+    {
+        std::promise<void> release;
+        auto released = release.get_future().share();
+        std::atomic<int> done{0};
+        {
+            ThreadPool pool(1, 1);
+            std::promise<void> started;
+            pool.submit([&] {
+                started.set_value();
+                released.wait();
+                ++done;
+            });
+            started.get_future().wait();
+            // the worker is busy, one task fits in the queue
+            EXPECT_TRUE(pool.trySubmit([&] { ++done; }));
+            EXPECT_FALSE(pool.trySubmit([&] { ++done; }));
+            release.set_value();
+            pool.submit([&] { ++done; });
+        }
+        EXPECT_EQ(done, 3);
+    }
+
+    TEST(ThreadPool, ParallelFor)
+    {
+        ParallelTeam team(4);
+        vector<int> hits(1000);
+        std::mutex mutex;
+        vector<std::pair<size_t, size_t>> chunks;
+        team.parallelFor(0, hits.size(), 100, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                ++hits[i];
+            std::lock_guard<std::mutex> lock(mutex);
+            chunks.emplace_back(begin, end);
+        });
+        EXPECT_EQ(hits, vector<int>(1000, 1));
+        EXPECT_EQ(chunks.size(), 4u);
+
+        // the loop runs on the caller and the published workers
+        std::set<int> tids;
+        team.parallelFor(0, 4, 1, [&](size_t, size_t) {
+            std::lock_guard<std::mutex> lock(mutex);
+            tids.insert(syscall(SYS_gettid));
+        });
+        std::set<int> members(team.getWorkerTids().begin(),
+                              team.getWorkerTids().end());
+        EXPECT_EQ(members.size(), 3u);
+        EXPECT_EQ(members.count(syscall(SYS_gettid)), 0u);
+        members.insert(syscall(SYS_gettid));
+        EXPECT_EQ(tids, members);
+
+        // members run in the caller's execution context
+        auto context = make_ref<ExecutionContextObj>(
+            NativeCpuRuntimeObj::getInstance(), nullptr, 64);
+        {
+            ExecutionScope scope(context);
+            std::atomic<int> seen{0};
+            team.parallelFor(0, 4, 1, [&](size_t, size_t) {
+                if (ExecutionContextObj::getCurrent() == context.get())
+                    ++seen;
+            });
+            EXPECT_EQ(seen, 4);
+        }
+        team.parallelFor(0, 4, 1, [&](size_t, size_t) {
+            EXPECT_EQ(ExecutionContextObj::getCurrent(), nullptr);
+        });
+
+        // the grain bounds the number of chunks
+        chunks.clear();
+        team.parallelFor(0, 150, 100, [&](size_t begin, size_t end) {
+            std::lock_guard<std::mutex> lock(mutex);
+            chunks.emplace_back(begin, end);
+        });
+        EXPECT_EQ(chunks.size(), 1u);
+
+        // nested loops run inline, exceptions reach the caller
+        std::atomic<int> inner{0};
+        team.parallelFor(0, 4, 1, [&](size_t, size_t) {
+            team.parallelFor(0, 100, 1, [&](size_t begin, size_t end) {
+                inner += end - begin;
+            });
+        });
+        EXPECT_EQ(inner, 400);
+        EXPECT_THROW(team.parallelFor(0, 4, 1,
+                                      [](size_t begin, size_t) {
+                                          IT_ASSERT(begin != 2);
+                                      }),
+                     Exception);
+
+        // a core set which cannot be pinned fails before any worker starts
+        EXPECT_THROW(ParallelTeam(2, {-1}), Exception);
+
+        // a scope redirects the loops of kernels to its team
+        auto runtime = make_ref<NativeCpuRuntimeObj>();
+        runtime->setParallelism(1);
+        {
+            TeamScope scope(&team);
+            EXPECT_EQ(runtime->getThreadCount(), 4u);
+            chunks.clear();
+            runtime->parallelFor(0, 1000, 100, [&](size_t begin, size_t end) {
+                std::lock_guard<std::mutex> lock(mutex);
+                chunks.emplace_back(begin, end);
+            });
+            EXPECT_EQ(chunks.size(), 4u);
+        }
+        EXPECT_EQ(runtime->getThreadCount(), 1u);
+    }
+
+    TEST(ThreadPool, RunAsync)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor a = g->addTensor({2, 3}, DataType::Float32);
+        Tensor b = g->addTensor({2, 3}, DataType::Float32);
+        auto mul = g->addOp<MulObj>(a, b, nullptr);
+        auto add = g->addOp<AddObj>(mul->getOutput(), a, nullptr);
+        Tensor c = add->getOutput();
+        g->dataMalloc();
+
+        auto bytes = [](const vector<float> &values) {
+            auto ptr = reinterpret_cast<const char *>(values.data());
+            return vector<char>(ptr, ptr + values.size() * sizeof(float));
+        };
+        vector<std::future<vector<vector<char>>>> results;
+        for (int i = 0; i < 32; ++i)
+        {
+            float v = i;
+            results.emplace_back(runtime->runAsync(
+                g, {{a, bytes({v, v, v, v, v, v})}, {b, bytes({0, 1, 2, 3, 4, 5})}},
+                {c}));
+        }
+        for (int i = 0; i < 32; ++i)
+        {
+            float v = i;
+            auto outputs = results[i].get();
+            ASSERT_EQ(outputs.size(), 1u);
+            EXPECT_EQ(outputs[0], bytes({v, 2 * v, 3 * v, 4 * v, 5 * v, 6 * v}));
+        }
+        // inputs of a wrong size are rejected before queuing
+        EXPECT_THROW(runtime->runAsync(g, {{a, bytes({1})}}, {c}), Exception);
+        EXPECT_THROW(runtime->setAsyncPool(1, 1), Exception);
+    }
+
+    TEST(ThreadPool, RunAsyncDropRuntime)
+    {
+        vector<std::future<vector<vector<char>>>> results;
+        {
+            auto runtime = make_ref<NativeCpuRuntimeObj>();
+            runtime->setAsyncPool(2, 64);
+            Graph g = make_ref<GraphObj>(runtime);
+            Tensor a = g->addTensor({1 << 16}, DataType::Float32);
+            auto relu = g->addOp<ReluObj>(a, nullptr);
+            Tensor b = relu->getOutput();
+            g->dataMalloc();
+            vector<char> input(a->getBytes(), 1);
+            for (int i = 0; i < 32; ++i)
+                results.emplace_back(runtime->runAsync(g, {{a, input}}, {b}));
+
+            // a graph of another runtime is rejected
+            Graph other = make_ref<GraphObj>(make_ref<NativeCpuRuntimeObj>());
+            EXPECT_THROW(runtime->runAsync(other, {}, {}), Exception);
+        }
+        // the queued requests hold the last Refs of the runtime, the last
+        // one finishing releases it on a worker of its own pool
+        for (auto &result : results)
+            EXPECT_EQ(result.get()[0], vector<char>((1 << 16) * 4, 1));
+    }
+} // namespace infini
@@ -41,4 +41,23 @@ TEST(ElementWise, NativeCpu) {
         Shape{2, 1, 1}, ExpectOutput{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11});
 }
 
+TEST(ElementWise, NativeCpuInt64) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto t1 = g->addTensor({2, 3}, DataType::Int64);
+    auto t2 = g->addTensor({3}, DataType::Int64);
+    auto op = g->addOp<SubObj>(t1, t2, nullptr);
+    g->dataMalloc();
+    auto p1 = t1->getRawDataPtr<int64_t *>();
+    auto p2 = t2->getRawDataPtr<int64_t *>();
+    for (size_t i = 0; i < t1->size(); ++i)
+        p1[i] = i;
+    for (size_t i = 0; i < t2->size(); ++i)
+        p2[i] = 1;
+
+    runtime->run(g);
+    EXPECT_TRUE(
+        op->getOutput()->equalData(vector<int64_t>{-1, 0, 1, 2, 3, 4}));
+}
+
 } // namespace infini
@@ -0,0 +1,71 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/perf_engine.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+
+#include "test.h"
+
+namespace infini {
+
+TEST(Matmul, NativeCpu) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+
+    // A is [2, 2, 3], B^T is broadcast to both batches
+    auto A = g->addTensor({2, 2, 3}, DataType::Float32);
+    auto B = g->addTensor({1, 2, 3}, DataType::Float32);
+    auto op = g->addOp<MatmulObj>(A, B, nullptr, false, true);
+    g->dataMalloc();
+    A->setData(IncrementalGenerator());
+    B->setData(IncrementalGenerator());
+
+    runtime->run(g);
+    EXPECT_TRUE(op->getOutput()->equalData(
+        vector<float>{5, 14, 14, 50, 23, 86, 32, 122}));
+}
+
+TEST(Matmul, NativeCpuTune) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    auto &perfEngine = PerfEngine::getInstance();
+    perfEngine.clear();
+
+    Graph g = make_ref<GraphObj>(runtime);
+    auto A = g->addTensor({3, 64, 48}, DataType::Float32);
+    auto B = g->addTensor({64, 40}, DataType::Float32);
+    auto op = g->addOp<MatmulObj>(A, B, nullptr, true, false);
+    g->dataMalloc();
+    A->setData(IncrementalGenerator());
+    B->setData(OneGenerator());
+
+    auto candidates = KernelRegistry::getInstance().getKernelCandidates(
+        KernelAttrs{Device::CPU, OpType::MatMul, IsaLevel::Generic}, op);
+    ASSERT_EQ(candidates.size(), 2u);
+
+    // Every candidate computes the same result.
+    Graph gRef = make_ref<GraphObj>(runtime);
+    auto ARef = gRef->addTensor({3, 64, 48}, DataType::Float32);
+    auto BRef = gRef->addTensor({64, 40}, DataType::Float32);
+    auto opRef = gRef->addOp<MatmulObj>(ARef, BRef, nullptr, true, false);
+    gRef->dataMalloc();
+    ARef->setData(IncrementalGenerator());
+    BRef->setData(OneGenerator());
+    std::get<0>(*candidates[0])->compute(op, runtime.get());
+    std::get<0>(*candidates[1])->compute(opRef, runtime.get());
+    EXPECT_TRUE(op->getOutput()->equalData(opRef->getOutput()));
+
+    runtime->run(g, true);
+    ASSERT_EQ(perfEngine.getRecords().size(), 1u);
+    auto [key, kernelName] = *perfEngine.getRecords().begin();
+    EXPECT_NE(key.find(op->getOpSignature()), string::npos);
+
+    // Records survive a round trip through a tuning file.
+    string path = ::testing::TempDir() + "matmul_tuning.txt";
+    perfEngine.save(path);
+    perfEngine.clear();
+    EXPECT_TRUE(perfEngine.load(path));
+    EXPECT_EQ(perfEngine.getRecord(key), kernelName);
+    perfEngine.clear();
+}
+
+} // namespace infini
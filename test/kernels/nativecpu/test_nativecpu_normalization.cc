@@ -0,0 +1,97 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/normalization.h"
+
+#include "test.h"
+#include <cmath>
+
+namespace infini {
+
+template <typename T>
+static void setValues(const Tensor &tensor, const vector<T> &values) {
+    tensor->setData([&](void *ptr, size_t size, DataType) {
+        std::copy_n(values.data(), size, static_cast<T *>(ptr));
+    });
+}
+
+// rows of len values around offset, which the variance must not depend on
+static vector<float> makeRows(size_t rows, size_t len, float offset) {
+    vector<float> values(rows * len);
+    for (size_t i = 0; i < values.size(); ++i)
+        values[i] = offset + std::sin(float(i) * 0.71f) * float(i % len % 5 + 1);
+    return values;
+}
+
+static void testNormNativeCpu(IsaLevel isa, OpType type, size_t rows,
+                              size_t len, float offset) {
+    auto runtime = make_ref<NativeCpuRuntimeObj>();
+    runtime->setIsaLevel(isa);
+    Graph g = make_ref<GraphObj>(runtime);
+
+    auto x = g->addTensor({(int)rows, (int)len}, DataType::Float32);
+    auto scale = g->addTensor({(int)len}, DataType::Float32);
+    auto bias = g->addTensor({(int)len}, DataType::Float32);
+    Operator op;
+    if (type == OpType::LayerNorm)
+        op = g->addOp<LayerNormObj>(x, scale, bias, nullptr);
+    else
+        op = g->addOp<RMSNormObj>(x, scale, nullptr);
+    g->dataMalloc();
+    auto values = makeRows(rows, len, offset);
+    vector<float> scales(len), biases(len);
+    for (size_t i = 0; i < len; ++i) {
+        scales[i] = 0.5f + float(i % 3);
+        biases[i] = float(i % 4) - 1.5f;
+    }
+    setValues(x, values);
+    setValues(scale, scales);
+    setValues(bias, biases);
+
+    runtime->run(g);
+    auto output = op->getOutput()->getRawDataPtr<float *>();
+    // the mean in float is off by the rounding of offset
+    double tolerance = 2e-4 + 2e-7 * offset;
+    for (size_t r = 0; r < rows; ++r) {
+        const float *row = values.data() + r * len;
+        double mean = 0, var = 0;
+        for (size_t i = 0; i < len; ++i)
+            mean += row[i];
+        mean /= len;
+        for (size_t i = 0; i < len; ++i)
+            var += type == OpType::LayerNorm
+                       ? (row[i] - mean) * (row[i] - mean)
+                       : double(row[i]) * row[i];
+        double rstd = 1 / std::sqrt(var / len + 1e-5);
+        for (size_t i = 0; i < len; ++i) {
+            double expected =
+                type == OpType::LayerNorm
+                    ? (row[i] - mean) * rstd * scales[i] + biases[i]
+                    : row[i] * rstd * scales[i];
+            ASSERT_NEAR(output[r * len + i], expected, tolerance)
+                << op->toString() << " at " << r << ", " << i;
+        }
+    }
+}
+
+TEST(LayerNorm, NativeCpu) {
+    for (auto isa : {IsaLevel::Generic, IsaLevel::AVX2}) {
+        // rows shorter than a vector, with tails, and long ones
+        testNormNativeCpu(isa, OpType::LayerNorm, 3, 5, 0);
+        testNormNativeCpu(isa, OpType::LayerNorm, 7, 43, 0);
+        testNormNativeCpu(isa, OpType::LayerNorm, 4, 768, 0);
+        // a large offset breaks the naive sum of squares formula, whose
+        // variance would be off by far more than the tolerance
+        testNormNativeCpu(isa, OpType::LayerNorm, 4, 768, 1e4);
+    }
+}
+
+TEST(RMSNorm, NativeCpu) {
+    for (auto isa : {IsaLevel::Generic, IsaLevel::AVX2}) {
+        testNormNativeCpu(isa, OpType::RMSNorm, 3, 5, 0);
+        testNormNativeCpu(isa, OpType::RMSNorm, 7, 43, 0.5);
+        testNormNativeCpu(isa, OpType::RMSNorm, 4, 768, 0);
+    }
+}
+
+} // namespace infini
@@ -0,0 +1,163 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/reduce.h"
+
+#include "test.h"
+#include <cmath>
+
+namespace infini {
+
+// the reduction of input over axes in double precision
+static vector<double> reduceReference(OpType type, const vector<double> &input,
+                                      const Shape &shape,
+                                      const vector<int> &axes) {
+    // output strides of the input dims, 0 for the reduced ones
+    vector<size_t> strides(shape.size());
+    size_t outputs = 1;
+    for (int i = int(shape.size()) - 1; i >= 0; --i) {
+        bool reduced = std::find(axes.begin(), axes.end(), i) != axes.end();
+        strides[i] = reduced ? 0 : outputs;
+        outputs *= reduced ? 1 : shape[i];
+    }
+    double identity = type == OpType::ReduceMax   ? -INFINITY
+                      : type == OpType::ReduceMin ? INFINITY
+                      : type == OpType::ReduceProd ? 1
+                                                   : 0;
+    vector<double> output(outputs, identity);
+    for (size_t i = 0; i < input.size(); ++i) {
+        size_t o = 0, rest = i;
+        for (int d = int(shape.size()) - 1; d >= 0; --d) {
+            o += rest % shape[d] * strides[d];
+            rest /= shape[d];
+        }
+        double &acc = output[o];
+        if (type == OpType::ReduceMax)
+            acc = std::max(acc, input[i]);
+        else if (type == OpType::ReduceMin)
+            acc = std::min(acc, input[i]);
+        else if (type == OpType::ReduceProd)
+            acc *= input[i];
+        else
+            acc += input[i];
+    }
+    if (type == OpType::ReduceMean)
+        for (auto &value : output)
+            value /= double(input.size() / outputs);
+    return output;
+}
+
+static Operator addReduce(const Graph &g, OpType type, Tensor x,
+                          const vector<int> &axes, bool keepDims) {
+    if (type == OpType::ReduceSum)
+        return g->addOp<ReduceSumObj>(x, nullptr, axes, keepDims);
+    if (type == OpType::ReduceMean)
+        return g->addOp<ReduceMeanObj>(x, nullptr, axes, keepDims);
+    if (type == OpType::ReduceMax)
+        return g->addOp<ReduceMaxObj>(x, nullptr, axes, keepDims);
+    if (type == OpType::ReduceMin)
+        return g->addOp<ReduceMinObj>(x, nullptr, axes, keepDims);
+    return g->addOp<ReduceProdObj>(x, nullptr, axes, keepDims);
+}
+
+template <typename T>
+static void testReduceNativeCpu(IsaLevel isa, OpType type, const Shape &shape,
+                                const vector<int> &axes,
+                                bool keepDims = true,
+                                bool infinities = false) {
+    auto runtime = make_ref<NativeCpuRuntimeObj>();
+    runtime->setIsaLevel(isa);
+    Graph g = make_ref<GraphObj>(runtime);
+
+    constexpr bool isFloat = std::is_floating_point_v<T>;
+    auto dtype = isFloat ? DataType::Float32 : DataType::Int32;
+    auto input = g->addTensor(shape, dtype);
+    Operator op = addReduce(g, type, input, axes, keepDims);
+    g->dataMalloc();
+    vector<T> values(input->size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        // products stay near 1 so that long ones neither overflow nor
+        // vanish
+        if (type == OpType::ReduceProd)
+            values[i] = isFloat ? T(1 + 0.01 * std::sin(i * 0.37))
+                                : T(i % 3 == 0 ? -1 : 1);
+        else
+            values[i] = isFloat ? T(4 * std::sin(i * 0.37)) : T(i % 11) - 5;
+    }
+    // the first half of the input holds the infinity a max or min ignores,
+    // leading rows are made of it alone
+    if (infinities)
+        std::fill_n(values.begin(), values.size() / 2,
+                    type == OpType::ReduceMax ? -INFINITY : INFINITY);
+    input->setData([&](void *ptr, size_t size, DataType) {
+        std::copy_n(values.data(), size, static_cast<T *>(ptr));
+    });
+
+    runtime->run(g);
+    auto reduceOp = as<ReduceObj>(op);
+    auto expected = reduceReference(
+        type, vector<double>(values.begin(), values.end()), shape,
+        reduceOp->getAxes());
+    auto output = op->getOutput();
+    ASSERT_EQ(output->size(), expected.size()) << op->toString();
+    auto outptr = output->getRawDataPtr<T *>();
+    // sums of n values of magnitude 4 round within about sqrt(n) ulps of 4
+    double count = double(input->size()) / expected.size();
+    double tolerance = isFloat ? 4e-6 * std::sqrt(count) : 0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        double expect = isFloat ? expected[i] : double(T(expected[i]));
+        if (std::isinf(expect)) {
+            ASSERT_EQ(outptr[i], expect) << op->toString() << " at " << i;
+            continue;
+        }
+        ASSERT_NEAR(outptr[i], expect,
+                    tolerance * std::max(1., std::fabs(expect)))
+            << op->toString() << " at " << i;
+    }
+}
+
+static const OpType reduceTypes[] = {OpType::ReduceSum, OpType::ReduceMean,
+                                     OpType::ReduceMax, OpType::ReduceMin,
+                                     OpType::ReduceProd};
+
+TEST(Reduce, NativeCpu) {
+    for (auto isa : {IsaLevel::Generic, IsaLevel::AVX2})
+        for (auto type : reduceTypes) {
+            // contiguous rows, with a tail to the vectorized kernel
+            testReduceNativeCpu<float>(isa, type, {37, 101}, {1});
+            // strided columns
+            testReduceNativeCpu<float>(isa, type, {101, 37}, {0}, false);
+            // several reduced groups, innermost reduced or kept
+            testReduceNativeCpu<float>(isa, type, {3, 50, 4, 20}, {1, 3});
+            testReduceNativeCpu<float>(isa, type, {6, 5, 7, 9}, {0, 2});
+            // columns wider than a chunk of columns
+            testReduceNativeCpu<float>(isa, type, {3, 2, 1500}, {1});
+            // dims of size 1 are dropped
+            testReduceNativeCpu<float>(isa, type, {4, 1, 5, 1}, {1, 2},
+                                       false);
+            // whole tensors, split into several chunks
+            testReduceNativeCpu<float>(isa, type, {7, 13}, {});
+            testReduceNativeCpu<float>(isa, type, {300, 1001}, {0, 1});
+        }
+    for (auto isa : {IsaLevel::Generic, IsaLevel::AVX2})
+        for (auto type : {OpType::ReduceMax, OpType::ReduceMin}) {
+            testReduceNativeCpu<float>(isa, type, {37, 101}, {1}, true, true);
+            testReduceNativeCpu<float>(isa, type, {101, 37}, {0}, true, true);
+            testReduceNativeCpu<float>(isa, type, {3, 2, 1500}, {2}, true,
+                                       true);
+            testReduceNativeCpu<float>(isa, type, {3, 2, 1500}, {1}, true,
+                                       true);
+        }
+}
+
+TEST(Reduce, NativeCpuInt32) {
+    for (auto type : reduceTypes) {
+        testReduceNativeCpu<int32_t>(IsaLevel::Generic, type, {37, 101}, {1});
+        testReduceNativeCpu<int32_t>(IsaLevel::Generic, type, {6, 5, 7, 9},
+                                     {0, 2});
+        testReduceNativeCpu<int32_t>(IsaLevel::Generic, type, {300, 1001},
+                                     {});
+    }
+}
+
+} // namespace infini
@@ -0,0 +1,100 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/softmax.h"
+
+#include "test.h"
+#include <cmath>
+
+namespace infini {
+
+// softmax or log softmax along axis in double precision
+static vector<double> softmaxReference(const vector<float> &input,
+                                       const Shape &shape, int axis,
+                                       bool isLog) {
+    size_t len = shape[axis], inner = 1;
+    for (size_t i = axis + 1; i < shape.size(); ++i)
+        inner *= shape[i];
+    size_t outer = input.size() / (len * inner);
+    vector<double> output(input.size());
+    for (size_t o = 0; o < outer; ++o)
+        for (size_t c = 0; c < inner; ++c) {
+            auto at = [&](size_t j) { return o * len * inner + j * inner + c; };
+            double max = input[at(0)], sum = 0;
+            for (size_t j = 1; j < len; ++j)
+                max = std::max<double>(max, input[at(j)]);
+            for (size_t j = 0; j < len; ++j)
+                sum += std::exp(input[at(j)] - max);
+            for (size_t j = 0; j < len; ++j)
+                output[at(j)] = isLog ? input[at(j)] - max - std::log(sum)
+                                      : std::exp(input[at(j)] - max) / sum;
+        }
+    return output;
+}
+
+static void testSoftmaxNativeCpu(IsaLevel isa, const Shape &shape, int axis,
+                                 bool isLog, float scale) {
+    auto runtime = make_ref<NativeCpuRuntimeObj>();
+    runtime->setIsaLevel(isa);
+    Graph g = make_ref<GraphObj>(runtime);
+
+    auto input = g->addTensor(shape, DataType::Float32);
+    Operator op;
+    if (isLog)
+        op = g->addOp<LogSoftmaxObj>(input, nullptr, axis);
+    else
+        op = g->addOp<SoftmaxObj>(input, nullptr, axis);
+    g->dataMalloc();
+    vector<float> values(input->size());
+    // scale far above the range of exp checks that the max is subtracted
+    for (size_t i = 0; i < values.size(); ++i)
+        values[i] = scale * std::sin(float(i) * 0.37f);
+    input->setData([&](void *ptr, size_t size, DataType) {
+        std::copy_n(values.data(), size, static_cast<float *>(ptr));
+    });
+
+    runtime->run(g);
+    int realAxis = as<SoftmaxObj>(op)->getAxis();
+    auto expected = softmaxReference(values, shape, realAxis, isLog);
+    auto output = op->getOutput()->getRawDataPtr<float *>();
+    // log softmax rounds x - max, which is of the order of scale
+    double tolerance = isLog ? 2e-7 * scale : 0;
+    for (size_t i = 0; i < values.size(); ++i)
+        ASSERT_NEAR(output[i], expected[i],
+                    1e-6 * std::max(1., std::fabs(expected[i])) + tolerance)
+            << op->toString() << " at " << i;
+}
+
+TEST(Softmax, NativeCpu) {
+    for (auto isa : {IsaLevel::Generic, IsaLevel::AVX2})
+        for (bool isLog : {false, true}) {
+            // the last axis, with a tail to the vectorized kernel
+            testSoftmaxNativeCpu(isa, {5, 37}, -1, isLog, 4);
+            testSoftmaxNativeCpu(isa, {3, 1000}, 1, isLog, 1000);
+            // inner axes, with partial column blocks
+            testSoftmaxNativeCpu(isa, {2, 17, 13}, 1, isLog, 4);
+            testSoftmaxNativeCpu(isa, {100, 70}, 0, isLog, 1000);
+        }
+}
+
+TEST(Softmax, NativeCpuInplace) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto input = g->addTensor({2, 4}, DataType::Float32);
+    auto first = g->addOp<SoftmaxObj>(input, nullptr);
+    auto softmax = g->addOp<SoftmaxObj>(first->getOutput(), nullptr);
+    g->dataMalloc();
+    input->setData(IncrementalGenerator());
+    runtime->run(g);
+    // the second softmax may run in place on the output of the first
+    auto output = softmax->getOutput()->getRawDataPtr<float *>();
+    for (int r = 0; r < 2; ++r) {
+        float sum = 0;
+        for (int c = 0; c < 4; ++c)
+            sum += output[r * 4 + c];
+        EXPECT_NEAR(sum, 1, 1e-6);
+    }
+    EXPECT_NEAR(output[0], 0.19502, 1e-5);
+}
+
+} // namespace infini
@@ -0,0 +1,198 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/perf_engine.h"
+#include "core/runtime.h"
+#include "operators/unary.h"
+
+#include "test.h"
+#include <cmath>
+#include <limits>
+
+namespace infini {
+
+static void testReluNativeCpu(IsaLevel isa) {
+    auto runtime = make_ref<NativeCpuRuntimeObj>();
+    runtime->setIsaLevel(isa);
+    Graph g = make_ref<GraphObj>(runtime);
+
+    auto input = g->addTensor({2, 3, 3}, DataType::Float32);
+    auto op = g->addOp<ReluObj>(input, nullptr);
+    g->dataMalloc();
+    input->setData([](void *ptr, size_t size, DataType) {
+        auto data = static_cast<float *>(ptr);
+        for (size_t i = 0; i < size; ++i)
+            data[i] = (float)i - 9;
+    });
+
+    runtime->run(g);
+    EXPECT_TRUE(op->getOutput()->equalData(
+        vector<float>{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8}));
+}
+
+TEST(Relu, NativeCpu) {
+    testReluNativeCpu(IsaLevel::Generic);
+    testReluNativeCpu(IsaLevel::AVX2);
+}
+
+template <typename T>
+static void setValues(const Tensor &tensor, const vector<T> &values) {
+    tensor->setData([&](void *ptr, size_t size, DataType) {
+        std::copy_n(values.data(), size, static_cast<T *>(ptr));
+    });
+}
+
+// Float32 results are within maxUlp of a double precision reference, or
+// within maxAbs in absolute terms.
+template <typename Op>
+static void testActivationNativeCpu(IsaLevel isa, double (*reference)(double),
+                                    float lo, float hi, double maxUlp,
+                                    double maxAbs = 0) {
+    auto runtime = make_ref<NativeCpuRuntimeObj>();
+    runtime->setIsaLevel(isa);
+    Graph g = make_ref<GraphObj>(runtime);
+
+    // an odd size leaves a tail to the vectorized kernels
+    const size_t n = 100003;
+    auto input = g->addTensor({(int)n}, DataType::Float32);
+    Operator op = g->addOp<Op>(input, nullptr);
+    g->dataMalloc();
+    vector<float> values(n);
+    for (size_t i = 0; i < n; ++i)
+        values[i] = lo + (hi - lo) * float(i) / float(n - 1);
+    setValues(input, values);
+
+    runtime->run(g);
+    auto output = op->getOutput()->getRawDataPtr<float *>();
+    for (size_t i = 0; i < n; ++i) {
+        double expected = reference(values[i]);
+        float rounded = float(expected);
+        double ulp = std::nextafter(std::fabs(rounded),
+                                    std::numeric_limits<float>::infinity()) -
+                     std::fabs(rounded);
+        double error = std::fabs(output[i] - expected);
+        EXPECT_TRUE(error <= maxUlp * ulp || error <= maxAbs)
+            << op->getOpType().toString() << "(" << values[i]
+            << ") = " << output[i] << ", expected " << expected;
+    }
+}
+
+static void testActivationSpecials(IsaLevel isa) {
+    auto runtime = make_ref<NativeCpuRuntimeObj>();
+    runtime->setIsaLevel(isa);
+    Graph g = make_ref<GraphObj>(runtime);
+
+    const float inf = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    vector<float> inputs{0, -0.f, 1, -1, inf, -inf, nan, 200, -200};
+    // repeated so that the vectorized kernels see every value
+    inputs.insert(inputs.end(), inputs.begin(), inputs.end());
+    auto x = g->addTensor({(int)inputs.size()}, DataType::Float32);
+    auto exp = g->addOp<ExpObj>(x, nullptr);
+    auto log = g->addOp<LogObj>(x, nullptr);
+    auto sigmoid = g->addOp<SigmoidObj>(x, nullptr);
+    auto tanh = g->addOp<TanhObj>(x, nullptr);
+    auto erf = g->addOp<ErfObj>(x, nullptr);
+    auto gelu = g->addOp<GeluObj>(x, nullptr);
+    g->dataMalloc();
+    setValues(x, inputs);
+    runtime->run(g);
+
+    // expected holds the results of the first half of inputs
+    auto check = [&](const Operator &op, vector<float> expected) {
+        auto output = op->getOutput()->getRawDataPtr<float *>();
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            float want = expected[i % expected.size()];
+            if (std::isnan(want))
+                EXPECT_TRUE(std::isnan(output[i]))
+                    << op->getOpType().toString() << "(" << inputs[i] << ")";
+            else
+                EXPECT_FLOAT_EQ(output[i], want)
+                    << op->getOpType().toString() << "(" << inputs[i] << ")";
+        }
+    };
+    check(exp, {1, 1, std::exp(1.f), std::exp(-1.f), inf, 0, nan, inf, 0});
+    check(log, {-inf, -inf, 0, nan, inf, nan, nan, std::log(200.f), nan});
+    check(sigmoid, {0.5, 0.5, 1 / (1 + std::exp(-1.f)),
+                    1 / (1 + std::exp(1.f)), 1, 0, nan, 1, 0});
+    check(tanh, {0, 0, std::tanh(1.f), std::tanh(-1.f), 1, -1, nan, 1, -1});
+    check(erf, {0, 0, std::erf(1.f), std::erf(-1.f), 1, -1, nan, 1, -1});
+    check(gelu, {0, 0, 0.5f * (1 + std::erf(1 / std::sqrt(2.f))),
+                 -0.5f * (1 - std::erf(1 / std::sqrt(2.f))), inf, 0, nan, 200,
+                 0});
+}
+
+static double sigmoidReference(double x) { return 1 / (1 + std::exp(-x)); }
+static double siluReference(double x) { return x / (1 + std::exp(-x)); }
+static double geluReference(double x) {
+    return 0.5 * x * std::erfc(-x * std::sqrt(0.5));
+}
+
+TEST(Activation, NativeCpu) {
+    for (auto isa : {IsaLevel::Generic, IsaLevel::AVX2}) {
+        testActivationNativeCpu<ExpObj>(isa, std::exp, -100, 88, 3);
+        testActivationNativeCpu<LogObj>(isa, std::log, 1e-30f, 1e30f, 3);
+        testActivationNativeCpu<LogObj>(isa, std::log, 0.25f, 4, 3);
+        testActivationNativeCpu<SigmoidObj>(isa, sigmoidReference, -80, 80,
+                                            3);
+        testActivationNativeCpu<SiluObj>(isa, siluReference, -80, 80, 4);
+        testActivationNativeCpu<TanhObj>(isa, std::tanh, -10, 10, 3);
+        testActivationNativeCpu<ErfObj>(isa, std::erf, -5, 5, 4);
+        testActivationNativeCpu<GeluObj>(isa, geluReference, -10, 10, 4);
+        testActivationNativeCpu<GeluObj>(isa, geluReference, -3, 0, 4);
+        testActivationSpecials(isa);
+    }
+}
+
+TEST(Activation, NativeCpuDouble) {
+    auto runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({4}, DataType::Double);
+    auto gelu = g->addOp<GeluObj>(x, nullptr);
+    g->dataMalloc();
+    setValues(x, vector<double>{-3, -1, 0, 2});
+    runtime->run(g);
+    auto output = gelu->getOutput()->getRawDataPtr<double *>();
+    EXPECT_DOUBLE_EQ(output[0], geluReference(-3));
+    EXPECT_DOUBLE_EQ(output[1], geluReference(-1));
+    EXPECT_DOUBLE_EQ(output[2], 0);
+    EXPECT_DOUBLE_EQ(output[3], geluReference(2));
+}
+
+TEST(Activation, NativeCpuTuneInplace) {
+    auto runtime = make_ref<NativeCpuRuntimeObj>();
+    runtime->setIsaLevel(IsaLevel::AVX2);
+    auto &perfEngine = PerfEngine::getInstance();
+    perfEngine.clear();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({1024}, DataType::Float32);
+    auto exp = g->addOp<ExpObj>(x, nullptr);
+    auto tanh = g->addOp<TanhObj>(exp->getOutput(), nullptr);
+    g->dataMalloc();
+    // tanh runs in place on the output of exp, tuning it times every
+    // candidate on the same buffer
+    EXPECT_EQ(tanh->getOutput()->getRawDataPtr<void *>(),
+              exp->getOutput()->getRawDataPtr<void *>());
+    setValues(x, vector<float>(1024, 0));
+    runtime->run(g, true);
+    auto output = tanh->getOutput()->getRawDataPtr<float *>();
+    for (int i = 0; i < 1024; ++i)
+        ASSERT_NEAR(output[i], std::tanh(1.f), 1e-6) << i;
+    perfEngine.clear();
+}
+
+TEST(KernelRegistry, IsaVariantSelection) {
+    auto &registry = KernelRegistry::getInstance();
+    auto generic = registry.getKernelItem(
+        KernelAttrs{Device::CPU, OpType::Relu, IsaLevel::Generic});
+    EXPECT_EQ(std::get<1>(generic), "reluNaive_CPU");
+    // No SSE4.2 variant is registered, the generic one is the best match.
+    auto sse = registry.getKernelItem(
+        KernelAttrs{Device::CPU, OpType::Relu, IsaLevel::SSE42});
+    EXPECT_EQ(std::get<1>(sse), "reluNaive_CPU");
+    // AVX-512 hosts pick the AVX2 variant.
+    auto avx512 = registry.getKernelItem(
+        KernelAttrs{Device::CPU, OpType::Relu, IsaLevel::AVX512});
+    EXPECT_EQ(std::get<1>(avx512), "reluAvx2_CPU");
+}
+
+} // namespace infini
@@ -0,0 +1,47 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/normalization.h"
+
+#include "test.h"
+
+namespace infini {
+
+    TEST(LayerNorm, ShapeInference)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({2, 3, 4}, DataType::Float32);
+        Tensor scale = g->addTensor({3, 4}, DataType::Float32);
+        Tensor bias = g->addTensor({1, 3, 4}, DataType::Float32);
+        auto op = g->addOp<LayerNormObj>(x, scale, bias, nullptr, -2);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 3, 4}));
+        EXPECT_EQ(op->getAxis(), 1);
+        EXPECT_TRUE(op->hasBias());
+        EXPECT_EQ(op->numInputs(), 3);
+
+        auto noBias = g->addOp<LayerNormObj>(x, g->addTensor({4}, DataType::Float32),
+                                             nullptr, nullptr);
+        EXPECT_FALSE(noBias->hasBias());
+        EXPECT_FLOAT_EQ(noBias->getEpsilon(), 1e-5);
+        // the scale must cover the normalized dims
+        EXPECT_THROW(g->addOp<LayerNormObj>(x, scale, nullptr, nullptr, -1),
+                     Exception);
+    }
+
+    TEST(RMSNorm, ShapeInference)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({2, 3, 4}, DataType::Float32);
+        auto op = g->addOp<RMSNormObj>(x, g->addTensor({4}, DataType::Float32),
+                                       nullptr, -1, 1e-6);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 3, 4}));
+        EXPECT_EQ(op->getAxis(), 2);
+        EXPECT_FLOAT_EQ(op->getEpsilon(), 1e-6);
+        EXPECT_THROW(g->addOp<RMSNormObj>(
+                         x, g->addTensor({3}, DataType::Float32), nullptr),
+                     Exception);
+    }
+
+} // namespace infini
@@ -0,0 +1,39 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/reduce.h"
+
+#include "test.h"
+
+namespace infini {
+
+    TEST(Reduce, ShapeInference)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor i0 = g->addTensor({2, 3, 4, 5}, DataType::Float32);
+        auto sum = g->addOp<ReduceSumObj>(i0, nullptr, vector<int>{-1, 1});
+        EXPECT_EQ(sum->getOutput()->getDims(), (Shape{2, 1, 4, 1}));
+        EXPECT_EQ(sum->getOpType(), OpType::ReduceSum);
+        EXPECT_EQ(sum->getAxes(), (vector<int>{1, 3}));
+        EXPECT_TRUE(sum->isReduced(3));
+        EXPECT_FALSE(sum->isReduced(2));
+
+        auto mean =
+            g->addOp<ReduceMeanObj>(i0, nullptr, vector<int>{2, 0}, false);
+        EXPECT_EQ(mean->getOutput()->getDims(), (Shape{3, 5}));
+        EXPECT_EQ(mean->getOpAttrVector(), (vector<int>{0, 0, 2}));
+
+        // no axes reduces every axis
+        auto max = g->addOp<ReduceMaxObj>(i0, nullptr);
+        EXPECT_EQ(max->getOutput()->getDims(), (Shape{1, 1, 1, 1}));
+        auto min = g->addOp<ReduceMinObj>(i0, nullptr, vector<int>{}, false);
+        EXPECT_EQ(min->getOutput()->getDims(), (Shape{}));
+
+        EXPECT_THROW(g->addOp<ReduceProdObj>(i0, nullptr, vector<int>{4}),
+                     Exception);
+        EXPECT_THROW(g->addOp<ReduceProdObj>(i0, nullptr, vector<int>{1, -3}),
+                     Exception);
+    }
+
+} // namespace infini
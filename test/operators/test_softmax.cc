@@ -0,0 +1,27 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/softmax.h"
+
+#include "test.h"
+
+namespace infini {
+
+    TEST(Softmax, ShapeInference)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor i0 = g->addTensor({2, 3, 4}, DataType::Float32);
+        auto op = g->addOp<SoftmaxObj>(i0, nullptr);
+        EXPECT_EQ(op->getOutput()->getDims(), (Shape{2, 3, 4}));
+        EXPECT_EQ(op->getOpType(), OpType::Softmax);
+        EXPECT_EQ(op->getAxis(), 2);
+
+        auto log = g->addOp<LogSoftmaxObj>(i0, nullptr, -2);
+        EXPECT_EQ(log->getOutput()->getDims(), (Shape{2, 3, 4}));
+        EXPECT_EQ(log->getOpType(), OpType::LogSoftmax);
+        EXPECT_EQ(log->getAxis(), 1);
+        EXPECT_THROW(g->addOp<SoftmaxObj>(i0, nullptr, 3), Exception);
+    }
+
+} // namespace infini